@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_BENCH_H
+#define COYOTE_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The result of running a benchmark.
+struct BenchmarkResult
+{
+	// The name of the benchmark.
+	std::string name;
+
+	// The parameters that the benchmark was run with, such as the thread count.
+	std::vector<std::pair<std::string, std::string>> parameters;
+
+	// The metrics measured by the benchmark, such as the time per operation.
+	std::vector<std::pair<std::string, double>> metrics;
+
+	BenchmarkResult(std::string benchmark_name) :
+		name(std::move(benchmark_name))
+	{
+	}
+
+	BenchmarkResult& parameter(const std::string& key, const std::string& value)
+	{
+		parameters.push_back(std::make_pair(key, value));
+		return *this;
+	}
+
+	BenchmarkResult& parameter(const std::string& key, uint64_t value)
+	{
+		return parameter(key, std::to_string(value));
+	}
+
+	BenchmarkResult& metric(const std::string& key, double value)
+	{
+		metrics.push_back(std::make_pair(key, value));
+		return *this;
+	}
+};
+
+// Options of a benchmark executable, parsed from the command line.
+struct BenchmarkOptions
+{
+	// Only benchmarks whose name contains this string are run.
+	std::string filter;
+
+	// The path of the JSON report, or empty to write it to the standard output.
+	std::string output_path;
+
+	// Multiplies the amount of work done by each benchmark.
+	double scale;
+
+	BenchmarkOptions(int argc, char** argv) :
+		scale(1)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg(argv[i]);
+			if (arg == "--filter" && i + 1 < argc)
+			{
+				filter = argv[++i];
+			}
+			else if (arg == "--output" && i + 1 < argc)
+			{
+				output_path = argv[++i];
+			}
+			else if (arg == "--scale" && i + 1 < argc)
+			{
+				scale = std::stod(argv[++i]);
+			}
+			else
+			{
+				std::cerr << "usage: " << argv[0] << " [--filter <name>] [--output <file>] [--scale <factor>]" << std::endl;
+				std::exit(1);
+			}
+		}
+	}
+
+	// Returns true if the benchmark with the specified name should run, else false.
+	bool is_selected(const std::string& name) const
+	{
+		return filter.empty() || name.find(filter) != std::string::npos;
+	}
+
+	// Returns the specified amount of work multiplied by the scale, which is at least one.
+	size_t scaled(size_t count) const
+	{
+		size_t result = (size_t)(count * scale);
+		return result > 0 ? result : 1;
+	}
+};
+
+// Collects benchmark results and writes them as JSON, so they can be compared across releases.
+class BenchmarkReport
+{
+private:
+	std::string suite;
+	std::vector<BenchmarkResult> results;
+
+public:
+	BenchmarkReport(std::string suite_name) :
+		suite(std::move(suite_name))
+	{
+	}
+
+	void add(BenchmarkResult result)
+	{
+		std::cerr << "[bench] " << result.name;
+		for (const auto& kvp : result.parameters)
+		{
+			std::cerr << " " << kvp.first << "=" << kvp.second;
+		}
+
+		for (const auto& kvp : result.metrics)
+		{
+			std::cerr << " " << kvp.first << ":" << kvp.second;
+		}
+
+		std::cerr << std::endl;
+		results.push_back(std::move(result));
+	}
+
+	void write(const BenchmarkOptions& options) const
+	{
+		if (options.output_path.empty())
+		{
+			write(std::cout);
+		}
+		else
+		{
+			std::ofstream file(options.output_path);
+			write(file);
+		}
+	}
+
+	void write(std::ostream& stream) const
+	{
+		stream << "{\n  \"suite\": \"" << suite << "\",\n  \"results\": [";
+		for (size_t idx = 0; idx < results.size(); idx++)
+		{
+			const BenchmarkResult& result = results[idx];
+			stream << (idx == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"parameters\": {";
+			for (size_t p = 0; p < result.parameters.size(); p++)
+			{
+				stream << (p == 0 ? "" : ", ") << "\"" << result.parameters[p].first << "\": \"" <<
+					result.parameters[p].second << "\"";
+			}
+
+			stream << "}, \"metrics\": {";
+			for (size_t m = 0; m < result.metrics.size(); m++)
+			{
+				stream << (m == 0 ? "" : ", ") << "\"" << result.metrics[m].first << "\": " << result.metrics[m].second;
+			}
+
+			stream << "}}";
+		}
+
+		stream << "\n  ]\n}" << std::endl;
+	}
+};
+
+// Returns the nanoseconds elapsed since the specified time.
+inline uint64_t elapsed_nanoseconds(std::chrono::steady_clock::time_point start_time)
+{
+	auto elapsed = std::chrono::steady_clock::now() - start_time;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+#endif // COYOTE_BENCH_H
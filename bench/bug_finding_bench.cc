@@ -0,0 +1,505 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "coyote/scheduler.h"
+
+using namespace coyote;
+
+// The body of a controlled operation, which returns false if a scheduler call failed, for example
+// because a deadlock was detected, in which case the operation must stop executing.
+using OperationBody = std::function<bool()>;
+
+bool is_success(ErrorCode error_code)
+{
+	return error_code == ErrorCode::Success;
+}
+
+// Runs the specified bodies as controlled operations of a new iteration, after invoking the setup
+// function from the main operation, and returns true if a deadlock was detected. The operation that
+// observes the deadlock detaches, which releases all other operations.
+bool run_operations(Scheduler& scheduler, const std::function<void()>& setup, const std::vector<OperationBody>& bodies)
+{
+	bool is_deadlock_detected = false;
+	auto on_failure = [&scheduler, &is_deadlock_detected]()
+	{
+		if (scheduler.error_code() == ErrorCode::DeadlockDetected)
+		{
+			is_deadlock_detected = true;
+			scheduler.detach();
+		}
+	};
+
+	scheduler.attach();
+	setup();
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		size_t id = i + 1;
+		scheduler.create_operation(id);
+		threads.push_back(std::make_unique<std::thread>([&scheduler, &bodies, &on_failure, id]()
+		{
+			if (!is_success(scheduler.start_operation(id)) || !bodies[id - 1]() ||
+				!is_success(scheduler.complete_operation(id)))
+			{
+				on_failure();
+			}
+		}));
+	}
+
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		if (!is_success(scheduler.join_operation(i + 1)))
+		{
+			on_failure();
+			break;
+		}
+	}
+
+	for (auto& thread : threads)
+	{
+		thread->join();
+	}
+
+	scheduler.detach();
+	return is_deadlock_detected;
+}
+
+// A mutex implemented on top of a scheduler resource.
+struct ControlledLock
+{
+	Scheduler& scheduler;
+	size_t resource_id;
+	bool is_locked;
+
+	ControlledLock(Scheduler& s, size_t id) :
+		scheduler(s),
+		resource_id(id),
+		is_locked(false)
+	{
+	}
+
+	// Creates the resource of the lock in the current iteration.
+	void create()
+	{
+		is_locked = false;
+		scheduler.create_resource(resource_id);
+	}
+
+	bool lock()
+	{
+		while (is_locked)
+		{
+			if (!is_success(scheduler.wait_resource(resource_id)))
+			{
+				return false;
+			}
+		}
+
+		is_locked = true;
+		return true;
+	}
+
+	bool unlock()
+	{
+		is_locked = false;
+		return is_success(scheduler.signal_resource(resource_id));
+	}
+};
+
+// Two operations increment a counter with a non-atomic read-modify-write.
+bool run_lost_update(Scheduler& scheduler)
+{
+	int counter = 0;
+	auto increment = [&]()
+	{
+		int value = counter;
+		if (!is_success(scheduler.schedule_next()))
+		{
+			return false;
+		}
+
+		counter = value + 1;
+		return true;
+	};
+
+	run_operations(scheduler, []() {}, { increment, increment });
+	return counter != 2;
+}
+
+// Three philosophers pick up their left fork before their right fork, which can deadlock.
+bool run_dining_philosophers(Scheduler& scheduler)
+{
+	constexpr size_t PHILOSOPHERS = 3;
+	std::vector<std::unique_ptr<ControlledLock>> forks;
+	std::vector<OperationBody> bodies;
+	for (size_t i = 0; i < PHILOSOPHERS; i++)
+	{
+		forks.push_back(std::make_unique<ControlledLock>(scheduler, i + 1));
+		bodies.push_back([&scheduler, &forks, i]()
+		{
+			ControlledLock& left = *forks[i];
+			ControlledLock& right = *forks[(i + 1) % PHILOSOPHERS];
+			return left.lock() && is_success(scheduler.schedule_next()) && right.lock() && right.unlock() &&
+				left.unlock();
+		});
+	}
+
+	return run_operations(scheduler, [&forks]()
+	{
+		for (auto& fork : forks)
+		{
+			fork->create();
+		}
+	}, bodies);
+}
+
+// A producer and a consumer share a bounded buffer, but check its state and wait for a signal in two
+// separate steps, so a signal sent in between is missed and both can wait forever.
+bool run_bounded_buffer(Scheduler& scheduler)
+{
+	constexpr size_t CAPACITY = 1;
+	constexpr size_t ITEMS = 3;
+	constexpr size_t NOT_EMPTY_ID = 1;
+	constexpr size_t NOT_FULL_ID = 2;
+
+	size_t count = 0;
+	bool is_overflow = false;
+	auto producer = [&]()
+	{
+		for (size_t i = 0; i < ITEMS; i++)
+		{
+			if (count == CAPACITY)
+			{
+				if (!is_success(scheduler.schedule_next()) || !is_success(scheduler.wait_resource(NOT_FULL_ID)))
+				{
+					return false;
+				}
+			}
+
+			is_overflow |= count == CAPACITY;
+			count++;
+			if (!is_success(scheduler.signal_resource(NOT_EMPTY_ID)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	auto consumer = [&]()
+	{
+		for (size_t i = 0; i < ITEMS; i++)
+		{
+			if (count == 0)
+			{
+				if (!is_success(scheduler.schedule_next()) || !is_success(scheduler.wait_resource(NOT_EMPTY_ID)))
+				{
+					return false;
+				}
+			}
+
+			is_overflow |= count == 0;
+			count--;
+			if (!is_success(scheduler.signal_resource(NOT_FULL_ID)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	bool is_deadlock_detected = run_operations(scheduler, [&scheduler]()
+	{
+		scheduler.create_resource(NOT_EMPTY_ID);
+		scheduler.create_resource(NOT_FULL_ID);
+	}, { producer, consumer });
+	return is_deadlock_detected || is_overflow;
+}
+
+// Two operations use a lock-free stack whose compare-and-swap only compares the top node, so popping
+// a node that was removed and pushed back meanwhile corrupts the stack (the ABA problem).
+bool run_aba(Scheduler& scheduler)
+{
+	constexpr size_t NIL = SIZE_MAX;
+	constexpr size_t NODES = 3;
+
+	size_t top = 0;
+	size_t next[NODES];
+	std::vector<size_t> owned;
+
+	auto pop = [&](size_t& node)
+	{
+		while (true)
+		{
+			size_t old_top = top;
+			if (old_top == NIL)
+			{
+				node = NIL;
+				return true;
+			}
+
+			size_t new_top = next[old_top];
+			if (!is_success(scheduler.schedule_next()))
+			{
+				return false;
+			}
+
+			if (top == old_top)
+			{
+				top = new_top;
+				node = old_top;
+				owned.push_back(node);
+				return true;
+			}
+		}
+	};
+
+	auto push = [&](size_t node)
+	{
+		while (true)
+		{
+			size_t old_top = top;
+			next[node] = old_top;
+			if (!is_success(scheduler.schedule_next()))
+			{
+				return false;
+			}
+
+			if (top == old_top)
+			{
+				top = node;
+				owned.erase(std::find(owned.begin(), owned.end(), node));
+				return true;
+			}
+		}
+	};
+
+	auto pop_once = [&]()
+	{
+		size_t node;
+		return pop(node);
+	};
+
+	auto pop_twice_and_push_first = [&]()
+	{
+		size_t first, second;
+		return pop(first) && pop(second) && (first == NIL || push(first));
+	};
+
+	run_operations(scheduler, [&]()
+	{
+		top = 0;
+		for (size_t i = 0; i < NODES; i++)
+		{
+			next[i] = i + 1 < NODES ? i + 1 : NIL;
+		}
+
+		owned.clear();
+	}, { pop_once, pop_twice_and_push_first });
+
+	// Every node must be either owned by an operation or reachable from the top of the stack, but not both.
+	size_t reachable = 0;
+	for (size_t node = top; node != NIL && reachable <= NODES; node = next[node])
+	{
+		if (std::find(owned.begin(), owned.end(), node) != owned.end())
+		{
+			return true;
+		}
+
+		reachable++;
+	}
+
+	return reachable + owned.size() != NODES;
+}
+
+// Two operations lazily initialize a shared value with double-checked locking, but the initialized
+// flag is published before the value is written, so an operation can read an uninitialized value.
+bool run_double_checked_locking(Scheduler& scheduler)
+{
+	constexpr int INITIALIZED_VALUE = 42;
+	ControlledLock lock(scheduler, 1);
+	bool is_published = false;
+	int value = 0;
+	bool is_uninitialized_read = false;
+
+	auto get = [&]()
+	{
+		if (!is_published)
+		{
+			if (!lock.lock())
+			{
+				return false;
+			}
+
+			if (!is_published)
+			{
+				is_published = true;
+				if (!is_success(scheduler.schedule_next()))
+				{
+					return false;
+				}
+
+				value = INITIALIZED_VALUE;
+			}
+
+			if (!lock.unlock())
+			{
+				return false;
+			}
+		}
+
+		is_uninitialized_read |= value != INITIALIZED_VALUE;
+		return true;
+	};
+
+	run_operations(scheduler, [&lock]() { lock.create(); }, { get, get });
+	return is_uninitialized_read;
+}
+
+// A strategy configuration to evaluate.
+struct StrategyConfiguration
+{
+	std::string name;
+	std::function<void(Settings&, uint64_t)> configure;
+};
+
+// A buggy program to evaluate, which runs one iteration and returns true if it found the bug.
+struct BuggyProgram
+{
+	std::string name;
+	std::function<bool(Scheduler&)> run_iteration;
+};
+
+double mean(const std::vector<double>& values)
+{
+	double sum = 0;
+	for (double value : values)
+	{
+		sum += value;
+	}
+
+	return values.empty() ? 0 : sum / values.size();
+}
+
+double median(std::vector<double> values)
+{
+	if (values.empty())
+	{
+		return 0;
+	}
+
+	std::sort(values.begin(), values.end());
+	size_t middle = values.size() / 2;
+	return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+void bench_program(BenchmarkReport& report, const BenchmarkOptions& options, const BuggyProgram& program,
+	const StrategyConfiguration& configuration)
+{
+	const size_t seeds = options.scaled(10);
+	const size_t max_iterations = options.scaled(1000);
+
+	std::vector<double> iterations_to_bug;
+	std::vector<double> ms_to_bug;
+	for (uint64_t seed = 0; seed < seeds; seed++)
+	{
+		auto settings = std::make_unique<Settings>();
+		configuration.configure(*settings, seed);
+		auto scheduler = std::make_unique<Scheduler>(std::move(settings));
+
+		auto start_time = std::chrono::steady_clock::now();
+		for (size_t iteration = 1; iteration <= max_iterations; iteration++)
+		{
+			if (program.run_iteration(*scheduler))
+			{
+				scheduler->notify_bug_found();
+				ms_to_bug.push_back(elapsed_nanoseconds(start_time) / 1e6);
+				iterations_to_bug.push_back((double)iteration);
+				break;
+			}
+		}
+	}
+
+	report.add(BenchmarkResult("bug_finding")
+		.parameter("program", program.name)
+		.parameter("strategy", configuration.name)
+		.metric("seeds", (double)seeds)
+		.metric("max_iterations", (double)max_iterations)
+		.metric("found_ratio", (double)iterations_to_bug.size() / seeds)
+		.metric("mean_iterations_to_bug", mean(iterations_to_bug))
+		.metric("median_iterations_to_bug", median(iterations_to_bug))
+		.metric("mean_ms_to_bug", mean(ms_to_bug))
+		.metric("median_ms_to_bug", median(ms_to_bug)));
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	BenchmarkReport report("bug_finding_bench");
+
+	std::vector<BuggyProgram> programs = {
+		{ "lost_update", run_lost_update },
+		{ "dining_philosophers", run_dining_philosophers },
+		{ "bounded_buffer", run_bounded_buffer },
+		{ "aba", run_aba },
+		{ "double_checked_locking", run_double_checked_locking }
+	};
+
+	std::vector<StrategyConfiguration> configurations;
+	for (size_t probability : { 100, 50, 10 })
+	{
+		configurations.push_back({ "random_" + std::to_string(probability), [probability](Settings& settings, uint64_t seed)
+		{
+			settings.use_random_strategy(seed, probability);
+		} });
+	}
+
+	for (size_t bound : { 1, 3, 10 })
+	{
+		configurations.push_back({ "pct_" + std::to_string(bound), [bound](Settings& settings, uint64_t seed)
+		{
+			settings.use_pct_strategy(seed, bound);
+		} });
+	}
+
+	configurations.push_back({ "pct_adaptive_1_10", [](Settings& settings, uint64_t seed)
+	{
+		settings.use_adaptive_pct_strategy(seed, 1, 10);
+	} });
+	configurations.push_back({ "pctcp_3", [](Settings& settings, uint64_t seed)
+	{
+		settings.use_pctcp_strategy(seed, 3);
+	} });
+	configurations.push_back({ "qlearning", [](Settings& settings, uint64_t seed)
+	{
+		settings.use_qlearning_strategy(seed);
+	} });
+	configurations.push_back({ "portfolio", [](Settings& settings, uint64_t seed)
+	{
+		settings.use_portfolio_strategy(seed);
+	} });
+
+	for (const auto& program : programs)
+	{
+		for (const auto& configuration : configurations)
+		{
+			if (options.is_selected(program.name + "/" + configuration.name))
+			{
+				bench_program(report, options, program, configuration);
+			}
+		}
+	}
+
+	report.write(options);
+	return 0;
+}
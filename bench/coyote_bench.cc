@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "coyote/scheduler.h"
+
+using namespace coyote;
+
+constexpr uint64_t SEED = 42;
+
+std::unique_ptr<Scheduler> create_random_scheduler()
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_random_strategy(SEED);
+	return std::make_unique<Scheduler>(std::move(settings));
+}
+
+// Measures the cost of handing off the execution between operations running on different threads.
+void bench_handoff(BenchmarkReport& report, const BenchmarkOptions& options, size_t thread_count)
+{
+	const size_t steps_per_thread = options.scaled(thread_count > 64 ? 20 : 2000);
+	auto scheduler = create_random_scheduler();
+	scheduler->attach();
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		size_t id = i + 1;
+		scheduler->create_operation(id);
+		threads.push_back(std::make_unique<std::thread>([&scheduler, id, steps_per_thread]()
+		{
+			scheduler->start_operation(id);
+			for (size_t step = 0; step < steps_per_thread; step++)
+			{
+				scheduler->schedule_next();
+			}
+
+			scheduler->complete_operation(id);
+		}));
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		scheduler->join_operation(i + 1);
+	}
+
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	ExplorationStatistics statistics = scheduler->iteration_statistics();
+	scheduler->detach();
+	for (auto& thread : threads)
+	{
+		thread->join();
+	}
+
+	report.add(BenchmarkResult("handoff")
+		.parameter("threads", thread_count)
+		.metric("steps", (double)statistics.steps)
+		.metric("context_switches", (double)statistics.context_switches)
+		.metric("ns_per_step", (double)elapsed / statistics.steps)
+		.metric("ns_per_context_switch", (double)elapsed / statistics.context_switches));
+}
+
+// Measures the cost of attaching and detaching an iteration with only the main operation.
+void bench_attach_detach(BenchmarkReport& report, const BenchmarkOptions& options)
+{
+	const size_t cycles = options.scaled(100000);
+	auto scheduler = create_random_scheduler();
+
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < cycles; i++)
+	{
+		scheduler->attach();
+		scheduler->detach();
+	}
+
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	report.add(BenchmarkResult("attach_detach")
+		.metric("cycles", (double)cycles)
+		.metric("ns_per_cycle", (double)elapsed / cycles));
+}
+
+// Measures the cost of creating, signaling and deleting a resource without waiters.
+void bench_resource_churn(BenchmarkReport& report, const BenchmarkOptions& options)
+{
+	const size_t cycles = options.scaled(200000);
+	auto scheduler = create_random_scheduler();
+	scheduler->attach();
+
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < cycles; i++)
+	{
+		size_t resource_id = i + 1;
+		scheduler->create_resource(resource_id);
+		scheduler->signal_resource(resource_id);
+		scheduler->delete_resource(resource_id);
+	}
+
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	scheduler->detach();
+	report.add(BenchmarkResult("resource_churn")
+		.metric("cycles", (double)cycles)
+		.metric("ns_per_cycle", (double)elapsed / cycles));
+}
+
+// Measures the cost of two operations taking turns by waiting and signaling a shared resource.
+void bench_wait_signal(BenchmarkReport& report, const BenchmarkOptions& options)
+{
+	const size_t rounds = options.scaled(20000);
+	const size_t resource_id = 1;
+	auto scheduler = create_random_scheduler();
+	scheduler->attach();
+	scheduler->create_resource(resource_id);
+
+	size_t turn = 1;
+	auto take_turns = [&scheduler, &turn, rounds, resource_id](size_t id, size_t next_id)
+	{
+		scheduler->start_operation(id);
+		for (size_t round = 0; round < rounds; round++)
+		{
+			while (turn != id)
+			{
+				scheduler->wait_resource(resource_id);
+			}
+
+			turn = next_id;
+			scheduler->signal_resource(resource_id);
+		}
+
+		scheduler->complete_operation(id);
+	};
+
+	scheduler->create_operation(1);
+	std::thread first(take_turns, 1, 2);
+	scheduler->create_operation(2);
+	std::thread second(take_turns, 2, 1);
+
+	auto start_time = std::chrono::steady_clock::now();
+	scheduler->join_operation(1);
+	scheduler->join_operation(2);
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+
+	scheduler->detach();
+	first.join();
+	second.join();
+	report.add(BenchmarkResult("wait_signal")
+		.metric("rounds", (double)rounds)
+		.metric("ns_per_round", (double)elapsed / (2 * rounds)));
+}
+
+// Measures the cost of disabling and enabling operations in a set of the specified size.
+void bench_operations(BenchmarkReport& report, const BenchmarkOptions& options, size_t operation_count)
+{
+	const size_t cycles = options.scaled(1000000 / (operation_count / 16));
+	Operations operations;
+	for (size_t id = 0; id < operation_count; id++)
+	{
+		operations.insert(id);
+	}
+
+	Random generator(SEED);
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < cycles; i++)
+	{
+		size_t id = generator.next() % operation_count;
+		operations.disable(id);
+		operations.enable(id);
+	}
+
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	report.add(BenchmarkResult("operations_enable_disable")
+		.parameter("operations", operation_count)
+		.metric("cycles", (double)cycles)
+		.metric("ns_per_cycle", (double)elapsed / cycles));
+}
+
+// Measures the cost of a scheduling decision of the specified strategy over enabled operations.
+template<typename StrategyT>
+void bench_strategy(BenchmarkReport& report, const BenchmarkOptions& options, Settings* settings,
+	const std::string& name, size_t operation_count)
+{
+	const size_t steps = options.scaled(1000000);
+	StrategyT strategy(settings);
+	Operations operations;
+
+	auto run_iteration = [&]()
+	{
+		operations.clear();
+		for (size_t id = 0; id < operation_count; id++)
+		{
+			operations.insert(id);
+			strategy.on_operation_created(id, Operation::ungrouped_id);
+			strategy.on_operation_enabled(id);
+		}
+
+		size_t current = 0;
+		for (size_t step = 0; step < steps; step++)
+		{
+			current = strategy.next_operation(operations, current);
+		}
+	};
+
+	// The first iteration lets strategies such as PCT learn the schedule length.
+	run_iteration();
+	strategy.prepare_next_iteration(2);
+
+	auto start_time = std::chrono::steady_clock::now();
+	run_iteration();
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	report.add(BenchmarkResult("strategy_decision")
+		.parameter("strategy", name)
+		.parameter("operations", operation_count)
+		.metric("steps", (double)steps)
+		.metric("ns_per_step", (double)elapsed / steps));
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	BenchmarkReport report("coyote_bench");
+
+	if (options.is_selected("handoff"))
+	{
+		for (size_t thread_count : { 2, 8, 64, 512 })
+		{
+			bench_handoff(report, options, thread_count);
+		}
+	}
+
+	if (options.is_selected("attach_detach"))
+	{
+		bench_attach_detach(report, options);
+	}
+
+	if (options.is_selected("resource_churn"))
+	{
+		bench_resource_churn(report, options);
+	}
+
+	if (options.is_selected("wait_signal"))
+	{
+		bench_wait_signal(report, options);
+	}
+
+	if (options.is_selected("operations_enable_disable"))
+	{
+		for (size_t operation_count : { 16, 256, 4096 })
+		{
+			bench_operations(report, options, operation_count);
+		}
+	}
+
+	if (options.is_selected("strategy_decision"))
+	{
+		Settings random_settings;
+		random_settings.use_random_strategy(SEED);
+		Settings pct_settings;
+		pct_settings.use_pct_strategy(SEED, 10);
+		for (size_t operation_count : { 2, 64, 512 })
+		{
+			bench_strategy<RandomStrategy>(report, options, &random_settings, "random", operation_count);
+			bench_strategy<PCTStrategy>(report, options, &pct_settings, "pct", operation_count);
+		}
+	}
+
+	report.write(options);
+	return 0;
+}
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <memory>
+#include "bench.h"
+#include "coyote/scheduler.h"
+
+using namespace coyote;
+
+// Prevents the compiler from removing the measured loops.
+volatile uint64_t sink;
+
+// Runs a loop of cheap work, optionally instrumented with scheduler calls, and returns the elapsed time.
+template<bool IsInstrumented>
+uint64_t run_loop(Scheduler& scheduler, size_t iterations)
+{
+	uint64_t value = 0;
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		if (IsInstrumented)
+		{
+			scheduler.schedule_next();
+			scheduler.signal_resource(1);
+		}
+
+		value = value * 31 + i;
+	}
+
+	uint64_t elapsed = elapsed_nanoseconds(start_time);
+	sink = value;
+	return elapsed;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	BenchmarkReport report("disabled_bench");
+
+#ifdef COYOTE_DISABLE
+	const std::string mode = "compiled_out";
+#else
+	const std::string mode = "runtime_disabled";
+#endif // COYOTE_DISABLE
+
+	const size_t iterations = options.scaled(10000000);
+	auto settings = std::make_unique<Settings>();
+	settings->disable_scheduling();
+	Scheduler scheduler(std::move(settings));
+
+	// Warm up, then take the fastest of a few runs to reduce noise.
+	uint64_t baseline = UINT64_MAX;
+	uint64_t instrumented = UINT64_MAX;
+	for (int run = 0; run < 5; run++)
+	{
+		baseline = std::min(baseline, run_loop<false>(scheduler, iterations));
+		instrumented = std::min(instrumented, run_loop<true>(scheduler, iterations));
+	}
+
+	const double calls = 2.0 * iterations;
+	report.add(BenchmarkResult("disabled_calls")
+		.parameter("mode", mode)
+		.metric("calls", calls)
+		.metric("baseline_ms", baseline / 1e6)
+		.metric("instrumented_ms", instrumented / 1e6)
+		.metric("ns_per_call", ((double)instrumented - (double)baseline) / calls)
+		.metric("overhead_ratio", (double)instrumented / baseline));
+	report.write(options);
+	return 0;
+}
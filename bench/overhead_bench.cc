@@ -0,0 +1,353 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "coyote/scheduler.h"
+
+using namespace coyote;
+
+// Runs a workload either uncontrolled, without a scheduler, or instrumented with a scheduler, which
+// controls the workload if it is enabled, or is only invoked if scheduling is disabled.
+class Harness
+{
+private:
+	std::vector<std::unique_ptr<std::thread>> threads;
+	size_t next_operation_id;
+
+public:
+	// The scheduler, or null if the workload is uncontrolled.
+	Scheduler* scheduler;
+
+	// True if the scheduler controls the workload, else false.
+	bool is_controlled;
+
+	Harness(Scheduler* s) :
+		next_operation_id(1),
+		scheduler(s),
+		is_controlled(false)
+	{
+	}
+
+	void attach()
+	{
+		is_controlled = scheduler != nullptr && scheduler->attach() == ErrorCode::Success;
+	}
+
+	void detach()
+	{
+		if (scheduler != nullptr)
+		{
+			scheduler->detach();
+		}
+	}
+
+	void spawn(const std::function<void()>& body)
+	{
+		size_t id = next_operation_id++;
+		if (scheduler != nullptr)
+		{
+			scheduler->create_operation(id);
+		}
+
+		threads.push_back(std::make_unique<std::thread>([this, id, body]()
+		{
+			if (scheduler != nullptr)
+			{
+				scheduler->start_operation(id);
+			}
+
+			body();
+			if (scheduler != nullptr)
+			{
+				scheduler->complete_operation(id);
+			}
+		}));
+	}
+
+	void join_all()
+	{
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			if (scheduler != nullptr)
+			{
+				scheduler->join_operation(i + 1);
+			}
+
+			threads[i]->join();
+		}
+
+		threads.clear();
+		next_operation_id = 1;
+	}
+};
+
+// A mutex that is instrumented with scheduling points.
+class HarnessMutex
+{
+private:
+	Harness& harness;
+	size_t resource_id;
+
+public:
+	std::mutex mutex;
+
+	HarnessMutex(Harness& h, size_t id) :
+		harness(h),
+		resource_id(id)
+	{
+		if (harness.scheduler != nullptr)
+		{
+			harness.scheduler->create_resource(resource_id);
+		}
+	}
+
+	void lock()
+	{
+		if (harness.scheduler != nullptr)
+		{
+			harness.scheduler->schedule_next();
+		}
+
+		if (harness.is_controlled)
+		{
+			while (!mutex.try_lock())
+			{
+				harness.scheduler->wait_resource(resource_id);
+			}
+		}
+		else
+		{
+			mutex.lock();
+		}
+	}
+
+	void unlock()
+	{
+		mutex.unlock();
+		if (harness.scheduler != nullptr)
+		{
+			harness.scheduler->signal_resource(resource_id);
+		}
+	}
+};
+
+// A condition variable that is instrumented with scheduling points.
+class HarnessCondition
+{
+private:
+	Harness& harness;
+	size_t resource_id;
+	std::condition_variable_any cv;
+
+public:
+	HarnessCondition(Harness& h, size_t id) :
+		harness(h),
+		resource_id(id)
+	{
+		if (harness.scheduler != nullptr)
+		{
+			harness.scheduler->create_resource(resource_id);
+		}
+	}
+
+	void wait(HarnessMutex& mutex)
+	{
+		if (harness.is_controlled)
+		{
+			// Releasing the mutex is not a scheduling point, so no signal can be missed before waiting.
+			mutex.unlock();
+			harness.scheduler->wait_resource(resource_id);
+			mutex.lock();
+		}
+		else
+		{
+			cv.wait(mutex.mutex);
+		}
+	}
+
+	void notify_all()
+	{
+		if (harness.scheduler != nullptr)
+		{
+			harness.scheduler->signal_resource(resource_id);
+		}
+
+		if (!harness.is_controlled)
+		{
+			cv.notify_all();
+		}
+	}
+};
+
+// Threads increment a shared counter in critical sections, as in the mutual exclusion test, and
+// returns the number of critical sections.
+size_t run_mutual_exclusion(Harness& harness, size_t scale)
+{
+	constexpr size_t THREADS = 4;
+	const size_t sections_per_thread = 250 * scale;
+
+	harness.attach();
+	HarnessMutex mutex(harness, 1);
+	size_t counter = 0;
+	for (size_t i = 0; i < THREADS; i++)
+	{
+		harness.spawn([&]()
+		{
+			for (size_t j = 0; j < sections_per_thread; j++)
+			{
+				mutex.lock();
+				counter++;
+				mutex.unlock();
+			}
+		});
+	}
+
+	harness.join_all();
+	harness.detach();
+	return counter;
+}
+
+// A producer hands items to a consumer through a one-slot buffer, synchronizing on resources as in
+// the resource synchronization test, and returns the number of items.
+size_t run_producer_consumer(Harness& harness, size_t scale)
+{
+	const size_t items = 250 * scale;
+
+	harness.attach();
+	HarnessMutex mutex(harness, 1);
+	HarnessCondition not_empty(harness, 2);
+	HarnessCondition not_full(harness, 3);
+	bool is_full = false;
+	size_t consumed = 0;
+
+	harness.spawn([&]()
+	{
+		for (size_t i = 0; i < items; i++)
+		{
+			mutex.lock();
+			while (is_full)
+			{
+				not_full.wait(mutex);
+			}
+
+			is_full = true;
+			not_empty.notify_all();
+			mutex.unlock();
+		}
+	});
+
+	harness.spawn([&]()
+	{
+		for (size_t i = 0; i < items; i++)
+		{
+			mutex.lock();
+			while (!is_full)
+			{
+				not_empty.wait(mutex);
+			}
+
+			is_full = false;
+			consumed++;
+			not_full.notify_all();
+			mutex.unlock();
+		}
+	});
+
+	harness.join_all();
+	harness.detach();
+	return consumed;
+}
+
+// The time and work of running a workload in some mode.
+struct Measurement
+{
+	double wall_ns;
+	double cpu_ns;
+	size_t work;
+};
+
+Measurement measure(const std::function<size_t(Harness&, size_t)>& workload, Scheduler* scheduler,
+	size_t iterations, size_t scale)
+{
+	Harness harness(scheduler);
+	size_t work = 0;
+	std::clock_t start_cpu = std::clock();
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		work += workload(harness, scale);
+	}
+
+	double wall_ns = (double)elapsed_nanoseconds(start_time);
+	double cpu_ns = 1e9 * (double)(std::clock() - start_cpu) / CLOCKS_PER_SEC;
+	return Measurement{ wall_ns, cpu_ns, work };
+}
+
+void report_measurement(BenchmarkReport& report, const std::string& workload, const std::string& mode,
+	const Measurement& measurement, const Measurement& baseline)
+{
+	// Any CPU time in addition to the uncontrolled run is attributed to the scheduler.
+	double scheduler_cpu_share = measurement.cpu_ns > baseline.cpu_ns ?
+		(measurement.cpu_ns - baseline.cpu_ns) / measurement.cpu_ns : 0;
+	report.add(BenchmarkResult("overhead")
+		.parameter("workload", workload)
+		.parameter("mode", mode)
+		.metric("work", (double)measurement.work)
+		.metric("wall_ms", measurement.wall_ns / 1e6)
+		.metric("throughput_per_sec", measurement.work / (measurement.wall_ns / 1e9))
+		.metric("overhead_ratio", measurement.wall_ns / baseline.wall_ns)
+		.metric("scheduler_cpu_share", scheduler_cpu_share));
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options(argc, argv);
+	BenchmarkReport report("overhead_bench");
+
+	const size_t iterations = options.scaled(20);
+	const size_t scale = 4;
+
+	std::vector<std::pair<std::string, std::function<size_t(Harness&, size_t)>>> workloads = {
+		{ "mutual_exclusion", run_mutual_exclusion },
+		{ "producer_consumer", run_producer_consumer }
+	};
+
+	std::vector<std::pair<std::string, std::function<void(Settings&)>>> modes = {
+		{ "disabled", [](Settings& settings) { settings.disable_scheduling(); } },
+		{ "random", [](Settings& settings) { settings.use_random_strategy(0); } },
+		{ "pct_3", [](Settings& settings) { settings.use_pct_strategy(0, 3); } },
+		{ "pctcp_3", [](Settings& settings) { settings.use_pctcp_strategy(0, 3); } },
+		{ "qlearning", [](Settings& settings) { settings.use_qlearning_strategy(0); } },
+		{ "portfolio", [](Settings& settings) { settings.use_portfolio_strategy(0); } }
+	};
+
+	for (const auto& workload : workloads)
+	{
+		if (!options.is_selected(workload.first))
+		{
+			continue;
+		}
+
+		Measurement baseline = measure(workload.second, nullptr, iterations, scale);
+		report_measurement(report, workload.first, "uncontrolled", baseline, baseline);
+		for (const auto& mode : modes)
+		{
+			auto settings = std::make_unique<Settings>();
+			mode.second(*settings);
+			Scheduler scheduler(std::move(settings));
+			Measurement measurement = measure(workload.second, &scheduler, iterations, scale);
+			report_measurement(report, workload.first, mode.first, measurement, baseline);
+		}
+	}
+
+	report.write(options);
+	return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_COMMAND_H
+#define COYOTE_COMMAND_H
+
+#include <cstdint>
+
+namespace coyote
+{
+	enum class CommandType : uint32_t
+	{
+		// Creates the operation with the target id.
+		CreateOperation = 0,
+		// Creates the operation with the target id in the group whose id is the argument.
+		CreateOperationInGroup,
+		// Starts the operation with the target id.
+		StartOperation,
+		// Joins the operation with the target id.
+		JoinOperation,
+		// Completes the operation with the target id.
+		CompleteOperation,
+		// Creates the resource with the target id, with the argument as its count of permits.
+		CreateResource,
+		// Deletes the resource with the target id.
+		DeleteResource,
+		// Waits the resource with the target id to be signaled.
+		WaitResource,
+		// Signals all operations that are waiting the resource with the target id.
+		SignalResource,
+		// Signals the operation whose id is the argument that the resource with the target id is available.
+		SignalResourceForOperation,
+		// Acquires a permit of the resource with the target id.
+		AcquireResource,
+		// Releases a permit of the resource with the target id.
+		ReleaseResource,
+		// Schedules the next operation. The target id and argument are ignored.
+		ScheduleNext,
+		// Creates a lock with the target id.
+		CreateLock
+	};
+
+	// A scheduler call in a batch that is executed by 'Scheduler::execute_batch'. The layout is fixed, so
+	// foreign-language hosts can encode commands without marshaling. A batch stops at the first command
+	// that fails, or that completes the operation of the calling thread, and the commands after it are
+	// not executed and report 'ErrorCode::CommandNotExecuted'.
+	struct Command
+	{
+		// The type of the command.
+		CommandType type;
+
+		// Reserved for alignment.
+		uint32_t reserved;
+
+		// The id of the operation or resource that the command targets.
+		uint64_t target_id;
+
+		// The argument of the command, depending on the type.
+		uint64_t argument;
+	};
+}
+
+#endif // COYOTE_COMMAND_H
@@ -13,6 +13,7 @@ namespace coyote
         Success = 0,
         Failure = 100,
         DeadlockDetected = 101,
+        PotentialLivelockDetected = 102,
         DuplicateOperation = 200,
         NotExistingOperation = 201,
         MainOperationExplicitlyCreated = 202,
@@ -23,10 +24,12 @@ namespace coyote
         OperationAlreadyCompleted = 207,
         DuplicateResource = 300,
         NotExistingResource = 301,
+        ResourceNotHeld = 302,
         ClientAttached = 400,
         ClientNotAttached = 401,
         InternalError = 500,
-        SchedulerDisabled = 501
+        SchedulerDisabled = 501,
+        CommandNotExecuted = 600
     };
 }
 
@@ -4,7 +4,9 @@
 #ifndef COYOTE_OPERATION_H
 #define COYOTE_OPERATION_H
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <unordered_set>
 #include <vector>
 #include "operation_status.h"
@@ -21,6 +23,9 @@ namespace coyote
 		std::unordered_set<size_t> pending_signal_resource_ids;
 
 	public:
+		// The group id of operations that were created without an explicit group.
+		static constexpr size_t ungrouped_id = SIZE_MAX;
+
 		// The unique id of this operation.
 		const size_t id;
 
@@ -36,10 +41,22 @@ namespace coyote
 		// True if this operation is currently scheduled, else false.
 		bool is_scheduled;
 
+		// True if this operation is waiting with a timeout, else false.
+		bool has_timer;
+
+		// The virtual time when the timer of this operation fires, if it has one.
+		std::chrono::nanoseconds timer_deadline;
+
+		// True if the last wait of this operation ended because its timer fired, else false.
+		bool is_timed_out;
+
 		Operation(size_t operation_id) noexcept :
 			id(operation_id),
 			status(OperationStatus::None),
-			is_scheduled(false)
+			is_scheduled(false),
+			has_timer(false),
+			timer_deadline(0),
+			is_timed_out(false)
 		{
 		}
 
@@ -99,6 +116,51 @@ namespace coyote
 			}
 		}
 
+		// Waits until the specified resource sends a signal, or until the operation gets scheduled
+		// first, in which case the wait times out. The operation stays enabled while it waits.
+		void wait_resource_signal_or_timeout(size_t resource_id)
+		{
+			status = OperationStatus::WaitResourceOrTimeout;
+			pending_signal_resource_ids.insert(resource_id);
+			is_timed_out = false;
+		}
+
+		// Waits until the virtual time reaches the specified deadline.
+		void wait_timer(std::chrono::nanoseconds deadline)
+		{
+			status = OperationStatus::WaitTimer;
+			set_timer(deadline);
+		}
+
+		// Sets a timer that stops the current wait of this operation at the specified deadline.
+		void set_timer(std::chrono::nanoseconds deadline)
+		{
+			has_timer = true;
+			timer_deadline = deadline;
+			is_timed_out = false;
+		}
+
+		// Returns the operations that this operation is waiting to join.
+		const std::unordered_set<size_t>& pending_operation_ids() const
+		{
+			return pending_join_operation_ids;
+		}
+
+		// Returns the resources that this operation is waiting for a signal.
+		const std::unordered_set<size_t>& pending_resource_ids() const
+		{
+			return pending_signal_resource_ids;
+		}
+
+		// Invoked when the timer or the controlled timeout of this operation fires, which enables the operation.
+		void on_timer()
+		{
+			status = OperationStatus::Enabled;
+			pending_signal_resource_ids.clear();
+			has_timer = false;
+			is_timed_out = true;
+		}
+
 		// Invoked when the specified operation completes.
 		bool on_join_operation(size_t operation_id)
 		{
@@ -141,6 +203,13 @@ namespace coyote
 				pending_signal_resource_ids.clear();
 				return true;
 			}
+			else if (status == OperationStatus::WaitResourceOrTimeout)
+			{
+				// If the operation is waiting for a signal or a timeout, then it is already enabled,
+				// so only stop waiting.
+				status = OperationStatus::Enabled;
+				pending_signal_resource_ids.clear();
+			}
 
 			return false;
 		}
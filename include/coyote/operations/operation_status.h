@@ -14,6 +14,8 @@ namespace coyote
         JoinAllOperations,
         WaitAnyResource,
         WaitAllResources,
+        WaitTimer,
+        WaitResourceOrTimeout,
         Completed
     };
 }
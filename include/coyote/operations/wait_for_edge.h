@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_WAIT_FOR_EDGE_H
+#define COYOTE_WAIT_FOR_EDGE_H
+
+#include <cstddef>
+
+namespace coyote
+{
+	// An edge of the wait-for graph, where a blocked operation waits for another operation that must
+	// either complete or release a lock before the blocked operation can be enabled again.
+	struct WaitForEdge
+	{
+		// The id of the blocked operation.
+		size_t operation_id;
+
+		// The id of the operation that the blocked operation waits for.
+		size_t target_operation_id;
+
+		// The id of the lock that the blocked operation waits to acquire, if it is not joining.
+		size_t resource_id;
+
+		// True if the blocked operation waits to join the target operation, else false, in which case
+		// it waits for the target operation to release the lock.
+		bool is_joining;
+	};
+}
+
+#endif // COYOTE_WAIT_FOR_EDGE_H
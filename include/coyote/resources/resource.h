@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_RESOURCE_H
+#define COYOTE_RESOURCE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace coyote
+{
+	class Resource
+	{
+	public:
+		// The owner id of a lock that no operation holds.
+		static constexpr size_t no_owner_id = SIZE_MAX;
+
+		// The unique id of this resource.
+		const size_t id;
+
+		// True if this resource is a lock, whose single permit is owned by the operation that holds it,
+		// else false.
+		const bool is_lock;
+
+		// Set of operations that are blocked until this resource sends a signal.
+		std::unordered_set<size_t> blocked_operation_ids;
+
+		// The operations that are blocked until they acquire a permit, in the order that they blocked.
+		std::vector<size_t> acquiring_operation_ids;
+
+		// The count of available permits.
+		size_t permits;
+
+		// The id of the operation that holds this lock, else 'no_owner_id'.
+		size_t owner_operation_id;
+
+		Resource(size_t resource_id, size_t initial_permits) noexcept :
+			Resource(resource_id, initial_permits, false)
+		{
+		}
+
+		Resource(size_t resource_id, size_t initial_permits, bool is_lock_resource) noexcept :
+			id(resource_id),
+			is_lock(is_lock_resource),
+			permits(initial_permits),
+			owner_operation_id(no_owner_id)
+		{
+		}
+
+		Resource(Resource&& resource) = delete;
+		Resource(Resource const&) = delete;
+
+		Resource& operator=(Resource&& resource) = delete;
+		Resource& operator=(Resource const&) = delete;
+
+		// Takes an available permit on behalf of the specified operation.
+		void take_permit(size_t operation_id) noexcept
+		{
+			permits--;
+			if (is_lock)
+			{
+				owner_operation_id = operation_id;
+			}
+		}
+
+		// Hands a released permit over to the specified waiting operation.
+		void hand_over_permit(size_t operation_id) noexcept
+		{
+			if (is_lock)
+			{
+				owner_operation_id = operation_id;
+			}
+		}
+
+		// Returns true if the specified operation is waiting to acquire a permit of this resource, else false.
+		bool is_acquiring(size_t operation_id) const
+		{
+			return std::find(acquiring_operation_ids.begin(), acquiring_operation_ids.end(), operation_id) !=
+				acquiring_operation_ids.end();
+		}
+
+		// Stops the specified operation from waiting for a signal or a permit of this resource.
+		void remove_blocked_operation(size_t operation_id)
+		{
+			blocked_operation_ids.erase(operation_id);
+			auto it = std::find(acquiring_operation_ids.begin(), acquiring_operation_ids.end(), operation_id);
+			if (it != acquiring_operation_ids.end())
+			{
+				acquiring_operation_ids.erase(it);
+			}
+		}
+	};
+}
+
+#endif // COYOTE_RESOURCE_H
@@ -5,29 +5,77 @@
 #define COYOTE_SCHEDULER_H
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "command.h"
 #include "error_code.h"
 #include "settings.h"
 #include "operations/operation.h"
 #include "operations/operations.h"
 #include "operations/operation_status.h"
+#include "operations/wait_for_edge.h"
+#include "resources/resource.h"
+#include "statistics/exploration_statistics.h"
+#include "statistics/latency_event.h"
+#include "statistics/latency_histogram.h"
+#include "statistics/latency_profile.h"
+#include "statistics/statistics_snapshot.h"
 #include "strategies/strategy.h"
 #include "strategies/random_strategy.h"
 #include "strategies/pct_strategy.h"
+#include "strategies/pctcp_strategy.h"
+#include "strategies/portfolio_strategy.h"
+#include "strategies/qlearning_strategy.h"
+#include "trace/trace_event.h"
+#include "trace/trace_sink.h"
 
 namespace coyote
 {
 	class Scheduler
 	{
 	private:
+		// The scheduler and operation that the current thread executes.
+		struct OperationContext
+		{
+			Scheduler* scheduler;
+			Operation* operation;
+
+			// The attach of the scheduler in which the operation was started.
+			uint64_t attach_epoch;
+		};
+
+		// The operation context of the current thread, which is set when it starts an operation.
+		static inline thread_local OperationContext thread_context = { nullptr, nullptr, 0 };
+
+		// Counts the attaches of all schedulers, so that a context from an earlier attach, or from a
+		// deleted scheduler at the same address, is never used.
+		static inline std::atomic<uint64_t> attach_epoch_count{ 0 };
+
+		// Protects the epochs of the attaches in progress.
+		static inline std::mutex live_attach_epochs_mutex;
+
 		// Configures the program exploration.
 		std::unique_ptr<Settings> configuration;
 
+		// True if scheduling is enabled, else false. This is cached from the settings, so that the API
+		// calls of a disabled scheduler reduce to a single predictable branch.
+		const bool is_scheduling_enabled;
+
+		// Which accesses of controlled atomics are scheduling points, cached from the settings.
+		const AtomicDensity atomic_density;
+
+		// The probability that an access of a controlled atomic is a scheduling point, if sampled.
+		const size_t atomic_probability;
+
 		// Strategy for exploring the execution of the client program.
 		std::unique_ptr<Strategy> strategy;
 
@@ -37,8 +85,14 @@ namespace coyote
 		// Vector of enabled and disabled operation ids.
 		Operations operations;
 
-		// Map from unique resource ids to blocked operation ids.
-		std::map<size_t, std::shared_ptr<std::unordered_set<size_t>>> resource_map;
+		// Map from unique resource ids to resources.
+		std::map<size_t, std::unique_ptr<Resource>> resource_map;
+
+		// The virtual time of the current testing iteration, which only advances when timers fire.
+		std::chrono::nanoseconds current_virtual_time;
+
+		// The pending timers, ordered by their deadline and then by the id of their operation.
+		std::set<std::pair<std::chrono::nanoseconds, size_t>> timers;
 
 		// Mutex that synchronizes access to the scheduler.
 		std::unique_ptr<std::mutex> mutex;
@@ -47,6 +101,13 @@ namespace coyote
 		// operations have started.
 		std::condition_variable pending_operations_cv;
 
+		// Conditional variable that can be used to block detaching until all released operations have
+		// stopped waiting, so that no operation is deleted while its thread is waiting on it.
+		std::condition_variable paused_operations_cv;
+
+		// Count of threads that are waiting for their operation to be scheduled.
+		size_t paused_operation_count;
+
 		// The id of the currently scheduled operation.
 		size_t scheduled_op_id;
 
@@ -65,6 +126,61 @@ namespace coyote
 		// The last assigned error code, else success.
 		ErrorCode last_error_code;
 
+		// The error that ended the current testing iteration early, which released all operations before
+		// the client detached, else success.
+		ErrorCode release_error_code;
+
+		// The cycle of operations that waited for each other in the last detected deadlock, if any.
+		std::vector<WaitForEdge> deadlock_cycle_edges;
+
+		// Statistics of the current testing iteration.
+		ExplorationStatistics current_iteration_statistics;
+
+		// Statistics accumulated across all testing iterations.
+		ExplorationStatistics accumulated_statistics;
+
+		// Snapshot of the statistics that is shared with the host.
+		StatisticsSnapshot shared_statistics;
+
+		// Latency histograms of the scheduler, if latency profiling is enabled, else null.
+		std::unique_ptr<LatencyProfile> latency_profile;
+
+		// The time when the last handoff to another operation started, if latency profiling is enabled.
+		std::chrono::steady_clock::time_point handoff_start_time;
+
+		// Receives the events of the explored schedules, if tracing is enabled, else null.
+		std::unique_ptr<TraceSink> trace_sink;
+
+		// The order of the next trace event in the current testing iteration.
+		uint64_t trace_sequence;
+
+		// The next resource id assigned by 'create_unique_resource' in the current testing iteration.
+		size_t next_unique_resource_id;
+
+		// The next operation id assigned by 'create_unique_operation' in the current testing iteration.
+		size_t next_unique_operation_id;
+
+		// The epoch of the current attach, which identifies the operation contexts that are valid.
+		uint64_t attach_epoch;
+
+		// The max number of scheduling steps of the current testing iteration, or zero if unbounded.
+		size_t max_iteration_steps;
+
+		// The max wall-clock duration of the current testing iteration, or zero if unbounded.
+		std::chrono::milliseconds max_iteration_time;
+
+		// The number of fairly scheduled steps after the current testing iteration exceeds its bounds.
+		size_t fair_scheduling_steps;
+
+		// The time when the current testing iteration started, if its duration is bounded.
+		std::chrono::steady_clock::time_point iteration_start_time;
+
+		// True if the current testing iteration exceeded its bounds and schedules operations fairly, else false.
+		bool is_scheduling_fairly;
+
+		// The step at which the current testing iteration started to schedule operations fairly.
+		size_t fair_scheduling_start_step;
+
 	public:
 		Scheduler() noexcept :
 			Scheduler(std::make_unique<Settings>())
@@ -73,35 +189,59 @@ namespace coyote
 		
 		Scheduler(std::unique_ptr<Settings> settings) noexcept :
 			configuration(std::move(settings)),
+			is_scheduling_enabled(configuration->exploration_strategy() != StrategyType::None),
+			atomic_density(configuration->atomic_scheduling_density()),
+			atomic_probability(configuration->atomic_scheduling_probability()),
 			strategy(create_strategy()),
+			current_virtual_time(0),
 			mutex(std::make_unique<std::mutex>()),
 			pending_operations_cv(),
+			paused_operations_cv(),
+			paused_operation_count(0),
 			scheduled_op_id(0),
 			pending_start_operation_count(0),
 			is_attached(false),
 			iteration_count(0),
-			last_error_code(ErrorCode::Success)
+			last_error_code(ErrorCode::Success),
+			release_error_code(ErrorCode::Success),
+			trace_sequence(0),
+			next_unique_resource_id(SIZE_MAX),
+			next_unique_operation_id(1),
+			attach_epoch(0),
+			max_iteration_steps(0),
+			max_iteration_time(0),
+			fair_scheduling_steps(0),
+			is_scheduling_fairly(false),
+			fair_scheduling_start_step(0)
+		{
+		}
+
+		~Scheduler()
 		{
+			// The operation contexts of the last attach must not be used once the scheduler is deleted.
+			remove_live_attach_epoch(attach_epoch);
 		}
 
 		// Attaches to the scheduler. This should be called at the beginning of a testing iteration.
 		// It creates a main operation with id '0'.
 		ErrorCode attach() noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::Attach);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
 	#ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::attach] attaching the main operation" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 
-				if (is_attached)
+				if (is_attached || release_error_code != ErrorCode::Success)
 				{
+					// The client must also detach if the scheduler ended the iteration early.
 					throw ErrorCode::ClientAttached;
 				}
 
@@ -115,8 +255,35 @@ namespace coyote
 					strategy->prepare_next_iteration(iteration_count);
 				}
 
-				create_operation_inner(main_op_id);
+				current_iteration_statistics.clear();
+				current_iteration_statistics.iterations = 1;
+				accumulated_statistics.iterations++;
+				shared_statistics.publish(current_iteration_statistics, accumulated_statistics);
+
+				trace_sequence = 0;
+				next_unique_resource_id = SIZE_MAX;
+				next_unique_operation_id = main_op_id + 1;
+				attach_epoch = ++attach_epoch_count;
+				add_live_attach_epoch(attach_epoch);
+				current_virtual_time = std::chrono::nanoseconds(0);
+				timers.clear();
+				deadlock_cycle_edges.clear();
+
+				max_iteration_steps = configuration->max_iteration_steps();
+				max_iteration_time = configuration->max_iteration_time();
+				fair_scheduling_steps = configuration->fair_scheduling_steps();
+				is_scheduling_fairly = false;
+				fair_scheduling_start_step = 0;
+				if (max_iteration_time.count() > 0)
+				{
+					iteration_start_time = std::chrono::steady_clock::now();
+				}
+
+				trace(TraceEventType::IterationStarted, iteration_count, 0);
+
+				create_operation_inner(main_op_id, Operation::ungrouped_id);
 				start_operation_inner(main_op_id, lock);
+				trace(TraceEventType::OperationScheduled, main_op_id, main_op_id);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -134,48 +301,46 @@ namespace coyote
 		// It completes the main operation with id '0' and releases all controlled operations. 
 		ErrorCode detach() noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::Detach);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
 	#ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::detach] releasing all operations" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 
-				if (!is_attached)
+				if (!is_attached && release_error_code == ErrorCode::Success)
 				{
 					throw ErrorCode::ClientNotAttached;
 				}
 
 				is_attached = false;
+				release_error_code = ErrorCode::Success;
+				remove_live_attach_epoch(attach_epoch);
+				if (thread_context.scheduler == this)
+				{
+					thread_context = { nullptr, nullptr, 0 };
+				}
 
-				Operation* main_op = operation_map.at(main_op_id).get();
-				main_op->status = OperationStatus::Completed;
-				operations.disable(main_op->id);
-
-				for (auto& kvp : operation_map)
+				trace(TraceEventType::IterationCompleted, iteration_count, 0);
+				if (trace_sink != nullptr)
 				{
-					Operation* next_op = kvp.second.get();
-					if (next_op->status != OperationStatus::Completed)
-					{
-	#ifdef COYOTE_DEBUG_LOG
-						std::cout << "[coyote::detach] canceling operation " << next_op->id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-						// If the operation has not already completed, then cancel it.
-						next_op->is_scheduled = true;
-						next_op->status = OperationStatus::Completed;
-						operations.disable(next_op->id);
-						next_op->cv.notify_all();
-					}
+					trace_sink->flush();
 				}
 
+				release_operations();
+
+				// Wait for the released operations to stop waiting before deleting them.
+				paused_operations_cv.wait(lock, [this]() { return paused_operation_count == 0; });
 				operation_map.clear();
 				operations.clear();
 				resource_map.clear();
+				timers.clear();
 				pending_start_operation_count = 0;
 			}
 			catch (ErrorCode error_code)
@@ -193,28 +358,66 @@ namespace coyote
 		// Creates a new operation with the specified id.
 		ErrorCode create_operation(size_t operation_id) noexcept
 		{
+			return create_operation(operation_id, Operation::ungrouped_id);
+		}
+
+		// Creates a new operation with the specified id that belongs to the group with the specified id.
+		// Strategies such as PCTCP can use groups to assign the same priority to related operations.
+		ErrorCode create_operation(size_t operation_id, size_t group_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::CreateOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::create_operation] creating operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
+				create_operation_locked(operation_id, group_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+		
+		// Creates a new operation with an id that is unique in the current testing iteration, and assigns
+		// the id to 'operation_id'. Ids are assigned densely upwards from '1', skipping the ids of existing
+		// operations, so explicitly chosen ids should not be mixed with assigned ones.
+		ErrorCode create_unique_operation(size_t& operation_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
 
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::CreateOperation);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
 				if (!is_attached)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw not_attached_error();
 				}
-				else if (operation_id == main_op_id)
+
+				while (operation_map.find(next_unique_operation_id) != operation_map.end())
 				{
-					throw ErrorCode::MainOperationExplicitlyCreated;
+					next_unique_operation_id++;
 				}
 
-				create_operation_inner(operation_id);
+				operation_id = next_unique_operation_id++;
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::create_unique_operation] creating operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				create_operation_inner(operation_id, Operation::ungrouped_id);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -227,32 +430,20 @@ namespace coyote
 
 			return last_error_code;
 		}
-		
+
 		// Starts executing the operation with the specified id.
 		ErrorCode start_operation(size_t operation_id) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::StartOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::start_operation] starting operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
-				{
-					throw ErrorCode::ClientNotAttached;
-				}
-				else if (operation_id == main_op_id)
-				{
-					throw ErrorCode::MainOperationExplicitlyStarted;
-				}
-
-				start_operation_inner(operation_id, lock);
+				start_operation_locked(operation_id, lock);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -269,50 +460,16 @@ namespace coyote
 		// Waits until the operation with the specified id has completed.
 		ErrorCode join_operation(size_t operation_id) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::JoinOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::join_operation] joining operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
-				{
-					throw ErrorCode::ClientNotAttached;
-				}
-
-				auto it = operation_map.find(operation_id);
-				if (it == operation_map.end())
-				{
-	#ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::join_operation] not existing operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-					throw ErrorCode::NotExistingOperation;
-				}
-
-				Operation* join_op = it->second.get();
-				if (join_op->status != OperationStatus::Completed)
-				{
-					join_op->blocked_operation_ids.insert(scheduled_op_id);
-
-					Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
-					scheduled_op->join_operation(operation_id);
-					operations.disable(scheduled_op->id);
-
-					// Waiting for the resource to be released, so schedule the next enabled operation.
-					schedule_next_inner(lock);
-				}
-	#ifdef COYOTE_DEBUG_LOG
-				else
-				{
-					std::cout << "[coyote::join_operation] already completed operation " << operation_id << std::endl;
-				}
-	#endif // COYOTE_DEBUG_LOG
+				join_operation_locked(operation_id, lock);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -329,13 +486,14 @@ namespace coyote
 		// Waits until the operations with the specified ids have completed.
 		ErrorCode join_operations(const size_t* operation_ids, size_t size, bool wait_all) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::JoinOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
 				if (wait_all)
 				{
@@ -352,7 +510,7 @@ namespace coyote
 
 				if (!is_attached)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw not_attached_error();
 				}
 
 				std::vector<size_t> join_operations;
@@ -373,6 +531,7 @@ namespace coyote
 					{
 						join_op->blocked_operation_ids.insert(scheduled_op_id);
 						join_operations.push_back(operation_id);
+						trace(TraceEventType::OperationJoining, scheduled_op_id, operation_id);
 					}
 	#ifdef COYOTE_DEBUG_LOG
 					else
@@ -384,9 +543,11 @@ namespace coyote
 
 				if (!join_operations.empty())
 				{
-					Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
+					Operation* scheduled_op = scheduled_operation();
 					scheduled_op->join_operations(join_operations, wait_all);
 					operations.disable(scheduled_op->id);
+					strategy->on_operation_blocked(scheduled_op->id);
+					detect_wait_for_cycle(scheduled_op);
 
 					// Waiting for the resources to be released, so schedule the next enabled operation.
 					schedule_next_inner(lock);
@@ -404,64 +565,25 @@ namespace coyote
 			return last_error_code;
 		}
 
-		// Completes executing the operation with the specified id and schedules the next operation.
-		ErrorCode complete_operation(size_t operation_id) noexcept
+		// Completes the operation that the calling thread started.
+		ErrorCode complete_operation() noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::CompleteOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::complete_operation] completing operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
-				{
-					throw ErrorCode::ClientNotAttached;
-				}
-				else if (operation_id == main_op_id)
-				{
-					throw ErrorCode::MainOperationExplicitlyCompleted;
-				}
-
-				auto it = operation_map.find(operation_id);
-				if (it == operation_map.end())
-				{
-	#ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::complete_operation] not existing operation " << operation_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-					throw ErrorCode::NotExistingOperation;
-				}
-
-				Operation* op = it->second.get();
-				if (op->status == OperationStatus::Completed)
-				{
-					throw ErrorCode::OperationAlreadyCompleted;
-				}
-				else if (op->status == OperationStatus::None)
+				Operation* op = current_operation();
+				if (op == nullptr)
 				{
 					throw ErrorCode::OperationNotStarted;
 				}
 
-				op->status = OperationStatus::Completed;
-				operations.remove(op->id);
-
-				// Notify any operations that are waiting to join this operation.
-				for (const auto& blocked_id : op->blocked_operation_ids)
-				{
-					Operation* blocked_op = operation_map.at(blocked_id).get();
-					if (blocked_op->on_join_operation(operation_id))
-					{
-						operations.enable(blocked_op->id);
-					}
-				}
-
-				// The current operation has completed, so schedule the next enabled operation.
-				schedule_next_inner(lock);
+				complete_operation_locked(op->id, lock);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -475,34 +597,19 @@ namespace coyote
 			return last_error_code;
 		}
 
-		// Creates a new resource with the specified id.
-		ErrorCode create_resource(size_t resource_id) noexcept
+		// Completes executing the operation with the specified id and schedules the next operation.
+		ErrorCode complete_operation(size_t operation_id) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::CompleteOperation);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::create_resource] creating resource " << resource_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
-				{
-					throw ErrorCode::ClientNotAttached;
-				}
-
-				auto it = resource_map.find(resource_id);
-				if (it != resource_map.end())
-				{
-					throw ErrorCode::DuplicateResource;
-				}
-
-				resource_map.insert(std::pair<size_t, std::shared_ptr<std::unordered_set<size_t>>>(
-					resource_id, std::make_shared<std::unordered_set<size_t>>()));
+				complete_operation_locked(operation_id, lock);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -516,41 +623,59 @@ namespace coyote
 			return last_error_code;
 		}
 
-		// Waits the resource with the specified id to become available and schedules the next operation.
-		ErrorCode wait_resource(size_t resource_id) noexcept
+		// Creates a new resource with the specified id.
+		ErrorCode create_resource(size_t resource_id) noexcept
 		{
+			return create_resource(resource_id, 0);
+		}
+
+		// Creates a new resource with the specified id and count of permits, which operations can take
+		// with 'acquire_resource' and give back with 'release_resource'.
+		ErrorCode create_resource(size_t resource_id, size_t permits) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
-				
 				std::unique_lock<std::mutex> lock(*mutex);
-	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::wait_resource] waiting resource " << resource_id << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
-				{
-					throw ErrorCode::ClientNotAttached;
-				}
+				create_resource_locked(resource_id, permits, false);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
 
-				Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
-				scheduled_op->wait_resource_signal(resource_id);
-				operations.disable(scheduled_op->id);
+			return last_error_code;
+		}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
-				{
-					throw ErrorCode::NotExistingResource;
-				}
+		// Creates a new resource with an id that is unique in the current testing iteration, and assigns
+		// the id to 'resource_id'. Ids are assigned downwards from SIZE_MAX, so they do not collide with
+		// the ids chosen by the client program.
+		ErrorCode create_unique_resource(size_t& resource_id) noexcept
+		{
+			return create_unique_resource(resource_id, 0);
+		}
 
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				blocked_operation_ids->insert(scheduled_op_id);
+		// Creates a new resource with a unique id and the specified count of permits, and assigns the id
+		// to 'resource_id'.
+		ErrorCode create_unique_resource(size_t& resource_id, size_t permits) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
 
-				// Waiting for the resource to be released, so schedule the next enabled operation.
-				schedule_next_inner(lock);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				create_unique_resource_locked(resource_id, permits, false);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -563,55 +688,137 @@ namespace coyote
 
 			return last_error_code;
 		}
-		
-		// Waits the resources with the specified ids to become available and schedules the next operation.
-		ErrorCode wait_resources(const size_t* resource_ids, size_t size, bool wait_all) noexcept
+
+		// Creates a new lock with the specified id, which is a resource with a single permit that is owned
+		// by the operation that acquired it until it releases it. Operations that wait to acquire a lock
+		// wait for its owner, so the scheduler can detect cycles of operations that wait for each other.
+		// Releasing a lock that the calling operation does not hold fails with 'ResourceNotHeld'.
+		ErrorCode create_lock(size_t resource_id) noexcept
 		{
-			try
+			if (!is_enabled())
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
+				return ErrorCode::SchedulerDisabled;
+			}
 
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				create_resource_locked(resource_id, 1, true);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Creates a new lock with a unique id, and assigns the id to 'resource_id'.
+		ErrorCode create_unique_lock(size_t& resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				create_unique_resource_locked(resource_id, 1, true);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Waits the resource with the specified id to become available and schedules the next operation.
+		ErrorCode wait_resource(size_t resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				wait_resource_locked(resource_id, lock);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+		
+		// Waits the resource with the specified id to become available, or until the specified timeout
+		// elapses in virtual time, and schedules the next operation. The timeout only fires when no
+		// operation is enabled. Sets 'is_signaled' to true if the resource was signaled, else false.
+		ErrorCode wait_resource_for(size_t resource_id, std::chrono::nanoseconds timeout, bool& is_signaled) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
 				std::unique_lock<std::mutex> lock(*mutex);
-				if (wait_all)
-				{
-	#ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::wait_resources] waiting all " << size << " resources" << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-				}
-				else
-				{
 	#ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::wait_resources] waiting any of " << size << " resources" << std::endl;
+				std::cout << "[coyote::wait_resource_for] waiting resource " << resource_id << " for "
+					<< timeout.count() << "ns" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
-				}
 
 				if (!is_attached)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw not_attached_error();
 				}
 
-				Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
-				scheduled_op->wait_resource_signals(resource_ids, size, wait_all);
-				operations.disable(scheduled_op->id);
-
-				for (size_t i = 0; i < size; i++)
+				auto it = resource_map.find(resource_id);
+				if (it == resource_map.end())
 				{
-					size_t resource_id = *(resource_ids + i);
-					auto it = resource_map.find(resource_id);
-					if (it == resource_map.end())
-					{
-						throw ErrorCode::NotExistingResource;
-					}
+					throw ErrorCode::NotExistingResource;
+				}
 
-					std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-					blocked_operation_ids->insert(scheduled_op_id);
+				is_signaled = false;
+				if (timeout.count() <= 0)
+				{
+					// The timeout has already elapsed, so only schedule the next operation.
+					schedule_next_inner(lock);
+					return last_error_code;
 				}
 
-				// Waiting for the resources to be released, so schedule the next enabled operation.
+				Operation* scheduled_op = scheduled_operation();
+				scheduled_op->wait_resource_signal(resource_id);
+				scheduled_op->set_timer(current_virtual_time + timeout);
+				timers.emplace(scheduled_op->timer_deadline, scheduled_op->id);
+				operations.disable(scheduled_op->id);
+				strategy->on_operation_blocked(scheduled_op->id);
+
+				it->second->blocked_operation_ids.insert(scheduled_op_id);
+				trace(TraceEventType::OperationWaitingResource, scheduled_op_id, resource_id);
+
+				// Waiting for the resource to be released or the timer to fire, so schedule the next operation.
 				schedule_next_inner(lock);
+				is_signaled = !scheduled_op->is_timed_out;
 			}
 			catch (ErrorCode error_code)
 			{
@@ -624,25 +831,30 @@ namespace coyote
 
 			return last_error_code;
 		}
-        
-		// Signals all waiting operations that the resource with the specified id is available.
-		ErrorCode signal_resource(size_t resource_id) noexcept
+
+		// Waits the resource with the specified id to become available, or until the exploration strategy
+		// decides that the wait times out, and schedules the next operation. The waiting operation stays
+		// enabled, and the wait times out if the strategy schedules it before the resource is signaled,
+		// so timeout races are explored without a duration. Sets 'is_signaled' to true if the resource
+		// was signaled, else false.
+		ErrorCode wait_resource_for(size_t resource_id, bool& is_signaled) noexcept
 		{
-			try
+			if (!is_enabled())
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
+				return ErrorCode::SchedulerDisabled;
+			}
 
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
 				std::unique_lock<std::mutex> lock(*mutex);
 	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::signal_resource] signaling all waiting operations about resource " << resource_id << std::endl;
+				std::cout << "[coyote::wait_resource_for] waiting resource " << resource_id << " or a timeout" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 
 				if (!is_attached)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw not_attached_error();
 				}
 
 				auto it = resource_map.find(resource_id);
@@ -651,17 +863,15 @@ namespace coyote
 					throw ErrorCode::NotExistingResource;
 				}
 
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				for (const auto& blocked_id : *blocked_operation_ids)
-				{
-					Operation* blocked_op = operation_map.at(blocked_id).get();
-					if (blocked_op->on_resource_signal(resource_id))
-					{
-						operations.enable(blocked_op->id);
-					}
-				}
+				is_signaled = false;
+				Operation* scheduled_op = scheduled_operation();
+				scheduled_op->wait_resource_signal_or_timeout(resource_id);
+				it->second->blocked_operation_ids.insert(scheduled_op_id);
+				trace(TraceEventType::OperationWaitingResource, scheduled_op_id, resource_id);
 
-				blocked_operation_ids->clear();
+				// Either another operation signals the resource, or this operation is scheduled first and times out.
+				schedule_next_inner(lock);
+				is_signaled = !scheduled_op->is_timed_out;
 			}
 			catch (ErrorCode error_code)
 			{
@@ -675,45 +885,104 @@ namespace coyote
 			return last_error_code;
 		}
 
-		// Signals the waiting operation that the resource with the specified id is available.
-		ErrorCode signal_resource(size_t resource_id, size_t operation_id) noexcept
+		// Blocks the currently scheduled operation until the specified duration elapses in virtual time,
+		// and schedules the next operation. Virtual time only advances when no operation is enabled, so
+		// sleeping does not block the thread for the duration. A zero duration only schedules the next
+		// operation.
+		ErrorCode sleep_for(std::chrono::nanoseconds duration) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::Sleep);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::sleep_for] sleeping for " << duration.count() << "ns" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw not_attached_error();
+				}
+
+				if (duration.count() > 0)
 				{
-					throw ErrorCode::SchedulerDisabled;
+					Operation* scheduled_op = scheduled_operation();
+					scheduled_op->wait_timer(current_virtual_time + duration);
+					timers.emplace(scheduled_op->timer_deadline, scheduled_op->id);
+					operations.disable(scheduled_op->id);
+					strategy->on_operation_blocked(scheduled_op->id);
+					trace(TraceEventType::OperationWaitingTimer, scheduled_op_id, (size_t)duration.count());
 				}
 
+				schedule_next_inner(lock);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Waits the resources with the specified ids to become available and schedules the next operation.
+		ErrorCode wait_resources(const size_t* resource_ids, size_t size, bool wait_all) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
 				std::unique_lock<std::mutex> lock(*mutex);
+				if (wait_all)
+				{
 	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::signal_resource] signaling waiting operation " << operation_id << " about resource "
-					<< resource_id << std::endl;
+					std::cout << "[coyote::wait_resources] waiting all " << size << " resources" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
-
-				if (!is_attached)
+				}
+				else
 				{
-					throw ErrorCode::ClientNotAttached;
+	#ifdef COYOTE_DEBUG_LOG
+					std::cout << "[coyote::wait_resources] waiting any of " << size << " resources" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
+				if (!is_attached)
 				{
-					throw ErrorCode::NotExistingResource;
+					throw not_attached_error();
 				}
 
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				auto op_it = blocked_operation_ids->find(operation_id);
-				if (op_it != blocked_operation_ids->end())
+				Operation* scheduled_op = scheduled_operation();
+				scheduled_op->wait_resource_signals(resource_ids, size, wait_all);
+				operations.disable(scheduled_op->id);
+				strategy->on_operation_blocked(scheduled_op->id);
+
+				for (size_t i = 0; i < size; i++)
 				{
-					Operation* blocked_op = operation_map.at(operation_id).get();
-					if (blocked_op->on_resource_signal(resource_id))
+					size_t resource_id = *(resource_ids + i);
+					auto it = resource_map.find(resource_id);
+					if (it == resource_map.end())
 					{
-						operations.enable(blocked_op->id);
+						throw ErrorCode::NotExistingResource;
 					}
 
-					blocked_operation_ids->erase(op_it);
+					it->second->blocked_operation_ids.insert(scheduled_op_id);
+					trace(TraceEventType::OperationWaitingResource, scheduled_op_id, resource_id);
 				}
+
+				// Waiting for the resources to be released, so schedule the next enabled operation.
+				schedule_next_inner(lock);
 			}
 			catch (ErrorCode error_code)
 			{
@@ -726,133 +995,1060 @@ namespace coyote
 
 			return last_error_code;
 		}
+        
+		// Signals all waiting operations that the resource with the specified id is available.
+		ErrorCode signal_resource(size_t resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
 
-		// Deletes the resource with the specified id.
-		ErrorCode delete_resource(size_t resource_id) noexcept
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::SignalResource);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				signal_resource_locked(resource_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Signals the waiting operation that the resource with the specified id is available.
+		ErrorCode signal_resource(size_t resource_id, size_t operation_id) noexcept
 		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::SignalResource);
 			try
 			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
+				std::unique_lock<std::mutex> lock(*mutex);
+				signal_resource_locked(resource_id, operation_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Acquires a permit of the resource with the specified id and schedules the next operation. If no
+		// permit is available, the operation waits until it receives a released permit.
+		ErrorCode acquire_resource(size_t resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				acquire_resource_locked(resource_id, lock);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Acquires a permit of the resource with the specified id without waiting, and schedules the next
+		// operation. Sets 'is_acquired' to true if a permit was acquired, else false.
+		ErrorCode try_acquire_resource(size_t resource_id, bool& is_acquired) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
 			}
 
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
 				std::unique_lock<std::mutex> lock(*mutex);
 	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::delete_resource] deleting resource " << resource_id << std::endl;
+				std::cout << "[coyote::try_acquire_resource] trying to acquire resource " << resource_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 
 				if (!is_attached)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw not_attached_error();
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
+				Resource* resource = get_resource(resource_id);
+				is_acquired = resource->permits > 0;
+				if (is_acquired)
 				{
-					throw ErrorCode::NotExistingResource;
+					resource->take_permit(scheduled_op_id);
+				}
+
+				schedule_next_inner(lock);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Acquires a permit of the resource with the specified id, waiting until it receives a released
+		// permit or until the specified timeout elapses in virtual time, and schedules the next operation.
+		// Sets 'is_acquired' to true if a permit was acquired, else false.
+		ErrorCode acquire_resource_for(size_t resource_id, std::chrono::nanoseconds timeout, bool& is_acquired) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::WaitResource);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::acquire_resource_for] acquiring resource " << resource_id << " for "
+					<< timeout.count() << "ns" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw not_attached_error();
+				}
+
+				Resource* resource = get_resource(resource_id);
+				is_acquired = resource->permits > 0;
+				if (is_acquired)
+				{
+					resource->take_permit(scheduled_op_id);
+					schedule_next_inner(lock);
+				}
+				else if (timeout.count() <= 0)
+				{
+					// The timeout has already elapsed, so only schedule the next operation.
+					schedule_next_inner(lock);
+				}
+				else
+				{
+					Operation* scheduled_op = wait_permit(resource);
+					scheduled_op->set_timer(current_virtual_time + timeout);
+					timers.emplace(scheduled_op->timer_deadline, scheduled_op->id);
+					schedule_next_inner(lock);
+					is_acquired = !scheduled_op->is_timed_out;
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Releases a permit of the resource with the specified id. If operations are waiting to acquire a
+		// permit, the strategy chooses which of them receives it, and only that operation is enabled.
+		ErrorCode release_resource(size_t resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::SignalResource);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				release_resource_locked(resource_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Deletes the resource with the specified id.
+		ErrorCode delete_resource(size_t resource_id) noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				delete_resource_locked(resource_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Schedules the next operation, which can include the currently executing operation.
+		// Only operations that are not blocked nor completed can be scheduled.
+		ErrorCode schedule_next() noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::ScheduleNext);
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				schedule_next_locked(lock);
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			return last_error_code;
+		}
+
+		// Executes the specified commands in order under a single acquisition of the scheduler lock, and
+		// writes the error code of each command to the corresponding entry of 'error_codes'. A command that
+		// schedules the next operation pauses the calling operation as usual, and the remaining commands
+		// execute once it is scheduled again. The batch stops at the first command that fails, or that
+		// completes the operation of the calling thread, and the commands after it are assigned the
+		// 'CommandNotExecuted' error code. Returns the last assigned error code.
+		ErrorCode execute_batch(const Command* commands, size_t size, ErrorCode* error_codes) noexcept
+		{
+			if (!is_enabled())
+			{
+				std::fill(error_codes, error_codes + size, ErrorCode::SchedulerDisabled);
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			LatencyTimer timer(latency_profile.get(), LatencyEvent::ExecuteBatch);
+			size_t executed_count = 0;
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::execute_batch] executing " << size << " commands" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				while (executed_count < size)
+				{
+					const Command& command = commands[executed_count];
+					Operation* op = command.type == CommandType::CompleteOperation ? current_operation() : nullptr;
+					bool is_completing_caller = op != nullptr && op->id == (size_t)command.target_id;
+
+					ErrorCode error_code = execute_command(command, lock);
+					error_codes[executed_count++] = error_code;
+					if (error_code != ErrorCode::Success || is_completing_caller)
+					{
+						// The calling thread is no longer controlled, or the next commands can depend on
+						// the failed one, so do not execute them.
+						break;
+					}
+				}
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+			}
+
+			std::fill(error_codes + executed_count, error_codes + size, ErrorCode::CommandNotExecuted);
+			return last_error_code;
+		}
+
+		// Returns a controlled nondeterministic boolean value.
+		bool next_boolean() noexcept
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::next_boolean] " << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			return strategy->next_boolean();
+		}
+
+		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range.
+		int next_integer(int max_value) noexcept
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::next_integer] " << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			return strategy->next_integer(max_value);
+		}
+
+		// Notifies the scheduler that the client program found a bug in the current testing iteration,
+		// which strategies can use as feedback for exploring the next iterations.
+		void notify_bug_found() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::notify_bug_found] bug found in iteration " << iteration_count << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			strategy->on_bug_found();
+		}
+
+		// Returns true if scheduling is enabled, else false. If 'COYOTE_DISABLE' is defined, this is
+		// always false, so the compiler can remove the body of every API call.
+		bool is_enabled() const noexcept
+		{
+	#ifdef COYOTE_DISABLE
+			return false;
+	#else
+			return is_scheduling_enabled;
+	#endif // COYOTE_DISABLE
+		}
+
+		// Returns true if an access of a controlled atomic must be a scheduling point, according to the
+		// configured density, else false.
+		bool is_atomic_scheduling_point(bool is_read_modify_write, std::memory_order order) noexcept
+		{
+			if (!is_attached)
+			{
+				return false;
+			}
+			else if (atomic_density == AtomicDensity::Synchronizing)
+			{
+				return is_read_modify_write || order == std::memory_order_seq_cst;
+			}
+			else if (atomic_density == AtomicDensity::Sampled)
+			{
+				return atomic_probability > 0 && (size_t)strategy->next_integer(100) < atomic_probability;
+			}
+
+			return true;
+		}
+
+		// Returns true if a client is attached to the scheduler, else false.
+		bool is_client_attached() noexcept
+		{
+			return is_attached;
+		}
+
+		// Returns the count of testing iterations that attached to the scheduler so far.
+		size_t testing_iteration() noexcept
+		{
+			return iteration_count;
+		}
+
+		// Returns the virtual time of the current testing iteration, which starts at zero when the client
+		// attaches and advances to the deadline of the earliest timer whenever no operation is enabled.
+		std::chrono::nanoseconds virtual_time() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			return current_virtual_time;
+		}
+
+		// Returns the scheduler that controls the operation of the calling thread, or null if the thread
+		// has not started an operation in an attach that is still in progress. This is safe to call after
+		// the scheduler that the thread was last controlled by has been detached or deleted.
+		static Scheduler* current_scheduler() noexcept
+		{
+			const OperationContext context = thread_context;
+			if (context.scheduler == nullptr)
+			{
+				return nullptr;
+			}
+
+			std::unique_lock<std::mutex> lock(live_attach_epochs_mutex);
+			return live_attach_epochs().count(context.attach_epoch) > 0 ? context.scheduler : nullptr;
+		}
+
+		// Sets 'operation_id' to the id of the operation that the calling thread started in the current
+		// testing iteration. Returns true if there is such an operation, else false.
+		bool current_operation_id(size_t& operation_id) noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			Operation* op = current_operation();
+			if (op == nullptr)
+			{
+				return false;
+			}
+
+			operation_id = op->id;
+			return true;
+		}
+
+		// Returns the id of the currently scheduled operation.
+		size_t scheduled_operation_id() noexcept
+		{
+			return scheduled_op_id;
+		}
+
+		// Returns a seed that can be used to reproduce the current testing iteration.
+		uint64_t random_seed() noexcept
+		{
+			return strategy->random_seed();
+		}
+
+		// Returns the type of the strategy that explores the current testing iteration.
+		StrategyType exploration_strategy() noexcept
+		{
+			return strategy->exploration_strategy();
+		}
+
+		// Returns the bound of the strategy that explores the current testing iteration.
+		size_t exploration_strategy_bound() noexcept
+		{
+			return strategy->exploration_strategy_bound();
+		}
+
+		// Returns the seed with which the strategy that explores the current testing iteration was created.
+		uint64_t exploration_strategy_seed() noexcept
+		{
+			return strategy->exploration_strategy_seed();
+		}
+
+		// Returns the number of testing iterations, including the current one, that have been explored by
+		// the strategy that explores the current testing iteration. Together with the type, bound and seed
+		// of the strategy, this reproduces an iteration that was explored by a portfolio of strategies.
+		size_t exploration_strategy_iteration() noexcept
+		{
+			return strategy->exploration_strategy_iteration();
+		}
+
+		// Returns the last error code, if there is one assigned.
+		ErrorCode error_code() noexcept
+		{
+			if (!is_enabled())
+			{
+				return ErrorCode::SchedulerDisabled;
+			}
+
+			return last_error_code;
+		}
+
+		// Returns the statistics of the current, or last completed, testing iteration.
+		ExplorationStatistics iteration_statistics() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			return current_iteration_statistics;
+		}
+
+		// Returns the statistics accumulated across all testing iterations.
+		ExplorationStatistics total_statistics() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			return accumulated_statistics;
+		}
+
+		// Returns the snapshot of the statistics that the scheduler publishes after each update, which a
+		// host can read at any time without copies, calls or locks. It is valid for the lifetime of the
+		// scheduler.
+		const StatisticsSnapshot* statistics_snapshot() const noexcept
+		{
+			return &shared_statistics;
+		}
+
+		// Returns the cycle of operations that waited for each other in the deadlock that ended the current,
+		// or last completed, testing iteration. It is empty if no such cycle was detected.
+		std::vector<WaitForEdge> deadlock_cycle() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			return deadlock_cycle_edges;
+		}
+
+		// Sets the sink that receives the events of the explored schedules, or disables tracing if the
+		// sink is null. This should be called before the first attach, or between testing iterations.
+		void set_trace_sink(std::unique_ptr<TraceSink> sink) noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			trace_sink = std::move(sink);
+		}
+
+		// Bounds the scheduling steps and the wall-clock duration of each testing iteration, and sets the
+		// number of fairly scheduled steps after a bound is exceeded, as the corresponding 'Settings'
+		// methods do. This should be called before the first attach, or between testing iterations.
+		void set_iteration_bounds(size_t max_steps, std::chrono::milliseconds max_time, size_t fair_steps) noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			configuration->bound_iteration_steps(max_steps);
+			configuration->bound_iteration_time(max_time);
+			configuration->use_fair_scheduling_suffix(fair_steps);
+		}
+
+		// Enables recording the latency of the scheduler API calls and of the handoffs between operations.
+		// This should be called before the first attach, as the API calls are not synchronized with it.
+		void enable_latency_profiling() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (latency_profile == nullptr)
+			{
+				latency_profile = std::make_unique<LatencyProfile>();
+			}
+		}
+
+		// Returns true if latency profiling is enabled, else false.
+		bool is_latency_profiling_enabled() noexcept
+		{
+			return latency_profile != nullptr;
+		}
+
+		// Returns the latency histogram of the specified event, which is empty if latency profiling
+		// is not enabled, or if the event is not one of the latency events.
+		const LatencyHistogram& latency_histogram(LatencyEvent event) noexcept
+		{
+			static const LatencyHistogram empty_histogram;
+			if (latency_profile == nullptr || !LatencyProfile::is_valid(event))
+			{
+				return empty_histogram;
+			}
+
+			return latency_profile->histogram(event);
+		}
+
+		// Removes all recorded latencies.
+		void clear_latency_histograms() noexcept
+		{
+			if (latency_profile != nullptr)
+			{
+				latency_profile->clear();
+			}
+		}
+
+	private:
+		Scheduler(Scheduler&& op) = delete;
+		Scheduler(Scheduler const&) = delete;
+
+		Scheduler& operator=(Scheduler&& op) = delete;
+		Scheduler& operator=(Scheduler const&) = delete;
+
+		std::unique_ptr<Strategy> create_strategy() noexcept
+		{
+			if (configuration->exploration_strategy() == StrategyType::PCT)
+			{
+				return std::make_unique<PCTStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::PCTCP)
+			{
+				return std::make_unique<PCTCPStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::QLearning)
+			{
+				return std::make_unique<QLearningStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::Portfolio)
+			{
+				return std::make_unique<PortfolioStrategy>(configuration.get());
+			}
+
+			return std::make_unique<RandomStrategy>(configuration.get());
+		}
+
+		// Executes the specified command of a batch while the scheduler lock is held, and returns its error code.
+		ErrorCode execute_command(const Command& command, std::unique_lock<std::mutex>& lock) noexcept
+		{
+			try
+			{
+				const size_t target_id = (size_t)command.target_id;
+				const size_t argument = (size_t)command.argument;
+				switch (command.type)
+				{
+				case CommandType::CreateOperation:
+					create_operation_locked(target_id, Operation::ungrouped_id);
+					break;
+				case CommandType::CreateOperationInGroup:
+					create_operation_locked(target_id, argument);
+					break;
+				case CommandType::StartOperation:
+					start_operation_locked(target_id, lock);
+					break;
+				case CommandType::JoinOperation:
+					join_operation_locked(target_id, lock);
+					break;
+				case CommandType::CompleteOperation:
+					complete_operation_locked(target_id, lock);
+					break;
+				case CommandType::CreateResource:
+					create_resource_locked(target_id, argument, false);
+					break;
+				case CommandType::DeleteResource:
+					delete_resource_locked(target_id);
+					break;
+				case CommandType::WaitResource:
+					wait_resource_locked(target_id, lock);
+					break;
+				case CommandType::SignalResource:
+					signal_resource_locked(target_id);
+					break;
+				case CommandType::SignalResourceForOperation:
+					signal_resource_locked(target_id, argument);
+					break;
+				case CommandType::AcquireResource:
+					acquire_resource_locked(target_id, lock);
+					break;
+				case CommandType::ReleaseResource:
+					release_resource_locked(target_id);
+					break;
+				case CommandType::ScheduleNext:
+					schedule_next_locked(lock);
+					break;
+				case CommandType::CreateLock:
+					create_resource_locked(target_id, 1, true);
+					break;
+				default:
+					throw ErrorCode::Failure;
+				}
+
+				return ErrorCode::Success;
+			}
+			catch (ErrorCode error_code)
+			{
+				last_error_code = error_code;
+				return error_code;
+			}
+			catch (...)
+			{
+				last_error_code = ErrorCode::Failure;
+				return ErrorCode::Failure;
+			}
+		}
+
+		// Implements 'create_operation' while the scheduler lock is held.
+		void create_operation_locked(size_t operation_id, size_t group_id)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::create_operation] creating operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+			else if (operation_id == main_op_id)
+			{
+				throw ErrorCode::MainOperationExplicitlyCreated;
+			}
+
+			create_operation_inner(operation_id, group_id);
+		}
+
+		// Implements 'start_operation' while the scheduler lock is held.
+		void start_operation_locked(size_t operation_id, std::unique_lock<std::mutex>& lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::start_operation] starting operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+			else if (operation_id == main_op_id)
+			{
+				throw ErrorCode::MainOperationExplicitlyStarted;
+			}
+
+			start_operation_inner(operation_id, lock);
+		}
+
+		// Implements 'join_operation' while the scheduler lock is held.
+		void join_operation_locked(size_t operation_id, std::unique_lock<std::mutex>& lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::join_operation] joining operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			auto it = operation_map.find(operation_id);
+			if (it == operation_map.end())
+			{
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::join_operation] not existing operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				throw ErrorCode::NotExistingOperation;
+			}
+
+			Operation* join_op = it->second.get();
+			if (join_op->status != OperationStatus::Completed)
+			{
+				join_op->blocked_operation_ids.insert(scheduled_op_id);
+				trace(TraceEventType::OperationJoining, scheduled_op_id, operation_id);
+
+				Operation* scheduled_op = scheduled_operation();
+				scheduled_op->join_operation(operation_id);
+				operations.disable(scheduled_op->id);
+				strategy->on_operation_blocked(scheduled_op->id);
+				detect_wait_for_cycle(scheduled_op);
+
+				// Waiting for the resource to be released, so schedule the next enabled operation.
+				schedule_next_inner(lock);
+			}
+	#ifdef COYOTE_DEBUG_LOG
+			else
+			{
+				std::cout << "[coyote::join_operation] already completed operation " << operation_id << std::endl;
+			}
+	#endif // COYOTE_DEBUG_LOG
+		}
+
+		// Implements 'complete_operation' while the scheduler lock is held.
+		void complete_operation_locked(size_t operation_id, std::unique_lock<std::mutex>& lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::complete_operation] completing operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+			else if (operation_id == main_op_id)
+			{
+				throw ErrorCode::MainOperationExplicitlyCompleted;
+			}
+
+			auto it = operation_map.find(operation_id);
+			if (it == operation_map.end())
+			{
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::complete_operation] not existing operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				throw ErrorCode::NotExistingOperation;
+			}
+
+			Operation* op = it->second.get();
+			if (op->status == OperationStatus::Completed)
+			{
+				throw ErrorCode::OperationAlreadyCompleted;
+			}
+			else if (op->status == OperationStatus::None)
+			{
+				throw ErrorCode::OperationNotStarted;
+			}
+
+			op->status = OperationStatus::Completed;
+			operations.remove(op->id);
+			strategy->on_operation_completed(op->id);
+			if (thread_context.operation == op)
+			{
+				thread_context = { nullptr, nullptr, 0 };
+			}
+
+			// Notify any operations that are waiting to join this operation.
+			for (const auto& blocked_id : op->blocked_operation_ids)
+			{
+				Operation* blocked_op = operation_map.at(blocked_id).get();
+				if (blocked_op->on_join_operation(operation_id))
+				{
+					operations.enable(blocked_op->id);
+					strategy->on_operation_enabled(blocked_op->id);
+					trace(TraceEventType::OperationEnabled, blocked_op->id, operation_id);
+				}
+			}
+
+			trace(TraceEventType::OperationCompleted, operation_id, 0);
+
+			// The current operation has completed, so schedule the next enabled operation.
+			schedule_next_inner(lock);
+		}
+
+		// Implements 'create_resource' while the scheduler lock is held.
+		void create_resource_locked(size_t resource_id, size_t permits, bool is_lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::create_resource] creating resource " << resource_id << " with "
+				<< permits << " permits" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			auto it = resource_map.find(resource_id);
+			if (it != resource_map.end())
+			{
+				throw ErrorCode::DuplicateResource;
+			}
+
+			resource_map.emplace(resource_id, std::make_unique<Resource>(resource_id, permits, is_lock));
+		}
+
+		// Implements 'create_unique_resource' while the scheduler lock is held.
+		void create_unique_resource_locked(size_t& resource_id, size_t permits, bool is_lock)
+		{
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			while (resource_map.find(next_unique_resource_id) != resource_map.end())
+			{
+				next_unique_resource_id--;
+			}
+
+			resource_id = next_unique_resource_id--;
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::create_unique_resource] creating resource " << resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			resource_map.emplace(resource_id, std::make_unique<Resource>(resource_id, permits, is_lock));
+		}
+
+		// Implements 'wait_resource' while the scheduler lock is held.
+		void wait_resource_locked(size_t resource_id, std::unique_lock<std::mutex>& lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::wait_resource] waiting resource " << resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			Operation* scheduled_op = scheduled_operation();
+			scheduled_op->wait_resource_signal(resource_id);
+			operations.disable(scheduled_op->id);
+			strategy->on_operation_blocked(scheduled_op->id);
+
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			it->second->blocked_operation_ids.insert(scheduled_op_id);
+			trace(TraceEventType::OperationWaitingResource, scheduled_op_id, resource_id);
+
+			// Waiting for the resource to be released, so schedule the next enabled operation.
+			schedule_next_inner(lock);
+		}
+
+		// Implements 'signal_resource' while the scheduler lock is held.
+		void signal_resource_locked(size_t resource_id)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::signal_resource] signaling all waiting operations about resource " << resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			trace(TraceEventType::ResourceSignaled, scheduled_op_id, resource_id);
+
+			std::unordered_set<size_t>& blocked_operation_ids = it->second->blocked_operation_ids;
+			for (const auto& blocked_id : blocked_operation_ids)
+			{
+				Operation* blocked_op = operation_map.at(blocked_id).get();
+				if (blocked_op->on_resource_signal(resource_id))
+				{
+					cancel_timer(blocked_op);
+					operations.enable(blocked_op->id);
+					strategy->on_operation_enabled(blocked_op->id);
+					trace(TraceEventType::OperationEnabled, blocked_op->id, scheduled_op_id);
+				}
+			}
+
+			blocked_operation_ids.clear();
+			strategy->on_resource_signaled(resource_id);
+		}
+
+		// Implements 'signal_resource' while the scheduler lock is held.
+		void signal_resource_locked(size_t resource_id, size_t operation_id)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::signal_resource] signaling waiting operation " << operation_id << " about resource "
+				<< resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
+
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			trace(TraceEventType::ResourceSignaled, scheduled_op_id, resource_id);
+
+			std::unordered_set<size_t>& blocked_operation_ids = it->second->blocked_operation_ids;
+			auto op_it = blocked_operation_ids.find(operation_id);
+			if (op_it != blocked_operation_ids.end())
+			{
+				Operation* blocked_op = operation_map.at(operation_id).get();
+				if (blocked_op->on_resource_signal(resource_id))
+				{
+					cancel_timer(blocked_op);
+					operations.enable(blocked_op->id);
+					strategy->on_operation_enabled(blocked_op->id);
+					trace(TraceEventType::OperationEnabled, blocked_op->id, scheduled_op_id);
 				}
 
-				resource_map.erase(resource_id);
+				blocked_operation_ids.erase(op_it);
 			}
-			catch (ErrorCode error_code)
+
+			strategy->on_resource_signaled(resource_id);
+		}
+
+		// Implements 'acquire_resource' while the scheduler lock is held.
+		void acquire_resource_locked(size_t resource_id, std::unique_lock<std::mutex>& lock)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::acquire_resource] acquiring resource " << resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
 			{
-				last_error_code = error_code;
+				throw not_attached_error();
 			}
-			catch (...)
+
+			Resource* resource = get_resource(resource_id);
+			if (resource->permits > 0)
 			{
-				last_error_code = ErrorCode::Failure;
+				resource->take_permit(scheduled_op_id);
+			}
+			else
+			{
+				detect_wait_for_cycle(wait_permit(resource));
 			}
 
-			return last_error_code;
+			schedule_next_inner(lock);
 		}
 
-		// Schedules the next operation, which can include the currently executing operation.
-		// Only operations that are not blocked nor completed can be scheduled.
-		ErrorCode schedule_next() noexcept
+		// Implements 'release_resource' while the scheduler lock is held.
+		void release_resource_locked(size_t resource_id)
 		{
-			try
-			{
-				if (configuration->exploration_strategy() == StrategyType::None)
-				{
-					throw ErrorCode::SchedulerDisabled;
-				}
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::release_resource] releasing resource " << resource_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
 
-				std::unique_lock<std::mutex> lock(*mutex);
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
 
-				if (!is_attached)
+			Resource* resource = get_resource(resource_id);
+			if (resource->is_lock)
+			{
+				// Only the owner can release a lock, which also rejects releasing it twice.
+				if (resource->owner_operation_id != scheduled_op_id)
 				{
-					throw ErrorCode::ClientNotAttached;
+					throw ErrorCode::ResourceNotHeld;
 				}
 
-				schedule_next_inner(lock);
+				resource->owner_operation_id = Resource::no_owner_id;
 			}
-			catch (ErrorCode error_code)
+
+			trace(TraceEventType::ResourceSignaled, scheduled_op_id, resource_id);
+
+			std::vector<size_t>& acquiring_operation_ids = resource->acquiring_operation_ids;
+			if (acquiring_operation_ids.empty())
 			{
-				last_error_code = error_code;
+				resource->permits++;
 			}
-			catch (...)
+			else
 			{
-				last_error_code = ErrorCode::Failure;
+				// Hand the permit over to the waiting operation that the strategy chooses.
+				size_t index = acquiring_operation_ids.size() == 1 ? 0 :
+					(size_t)strategy->next_integer((int)acquiring_operation_ids.size());
+				Operation* acquiring_op = operation_map.at(acquiring_operation_ids[index]).get();
+				acquiring_operation_ids.erase(acquiring_operation_ids.begin() + index);
+				resource->hand_over_permit(acquiring_op->id);
+				if (acquiring_op->on_resource_signal(resource_id))
+				{
+					cancel_timer(acquiring_op);
+					operations.enable(acquiring_op->id);
+					strategy->on_operation_enabled(acquiring_op->id);
+					trace(TraceEventType::OperationEnabled, acquiring_op->id, scheduled_op_id);
+				}
 			}
 
-			return last_error_code;
-		}
-
-		// Returns a controlled nondeterministic boolean value.
-		bool next_boolean() noexcept
-		{
-	#ifdef COYOTE_DEBUG_LOG
-			std::cout << "[coyote::next_boolean] " << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-			return strategy->next_boolean();
+			strategy->on_resource_signaled(resource_id);
 		}
 
-		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range.
-		int next_integer(int max_value) noexcept
+		// Implements 'delete_resource' while the scheduler lock is held.
+		void delete_resource_locked(size_t resource_id)
 		{
 	#ifdef COYOTE_DEBUG_LOG
-			std::cout << "[coyote::next_integer] " << std::endl;
+			std::cout << "[coyote::delete_resource] deleting resource " << resource_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
-			return strategy->next_integer(max_value);
-		}
 
-		// Returns the id of the currently scheduled operation.
-		size_t scheduled_operation_id() noexcept
-		{
-			return scheduled_op_id;
-		}
+			if (!is_attached)
+			{
+				throw not_attached_error();
+			}
 
-		// Returns a seed that can be used to reproduce the current testing iteration.
-		uint64_t random_seed() noexcept
-		{
-			return strategy->random_seed();
-		}
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
 
-		// Returns the last error code, if there is one assigned.
-		ErrorCode error_code() noexcept
-		{
-			return last_error_code;
+			resource_map.erase(resource_id);
 		}
 
-	private:
-		Scheduler(Scheduler&& op) = delete;
-		Scheduler(Scheduler const&) = delete;
-
-		Scheduler& operator=(Scheduler&& op) = delete;
-		Scheduler& operator=(Scheduler const&) = delete;
-
-		std::unique_ptr<Strategy> create_strategy() noexcept
+		// Implements 'schedule_next' while the scheduler lock is held.
+		void schedule_next_locked(std::unique_lock<std::mutex>& lock)
 		{
-			if (configuration->exploration_strategy() == StrategyType::PCT)
+			if (!is_attached)
 			{
-				return std::make_unique<PCTStrategy>(configuration.get());
+				throw not_attached_error();
 			}
 
-			return std::make_unique<RandomStrategy>(configuration.get());
+			schedule_next_inner(lock);
 		}
 
-		void create_operation_inner(size_t operation_id)
+		void create_operation_inner(size_t operation_id, size_t group_id)
 		{
 			auto it = operation_map.find(operation_id);
 			if (it == operation_map.end())
@@ -891,6 +2087,8 @@ namespace coyote
 
 			// Increment the count of created operations that have not yet started.
 			pending_start_operation_count += 1;
+			strategy->on_operation_created(operation_id, group_id);
+			trace(TraceEventType::OperationCreated, operation_id, scheduled_op_id);
 		}
 
 		void start_operation_inner(size_t operation_id, std::unique_lock<std::mutex>& lock)
@@ -916,6 +2114,9 @@ namespace coyote
 				throw ErrorCode::OperationAlreadyStarted;
 			}
 
+			// The calling thread executes the operation from now on.
+			thread_context = { this, op, attach_epoch };
+
 			// Decrement the count of pending operations.
 			pending_start_operation_count -= 1;
 	#ifdef COYOTE_DEBUG_LOG
@@ -931,19 +2132,25 @@ namespace coyote
 			{
 				op->status = OperationStatus::Enabled;
 				operations.insert(op->id);
+				strategy->on_operation_enabled(op->id);
+				trace(TraceEventType::OperationStarted, op->id, 0);
 				op->cv.notify_all();
 				while (!op->is_scheduled)
 				{
 	#ifdef COYOTE_DEBUG_LOG
 					std::cout << "[coyote::start_operation] pausing operation " << operation_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
-					op->cv.wait(lock);
+					pause_operation(op, lock);
 	#ifdef COYOTE_DEBUG_LOG
 					std::cout << "[coyote::start_operation] resuming operation " << operation_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 					if (!is_attached)
 					{
-						throw ErrorCode::ClientNotAttached;
+						throw not_attached_error();
+					}
+					else if (op->is_scheduled)
+					{
+						record_handoff();
 					}
 				}
 			}
@@ -965,6 +2172,12 @@ namespace coyote
 				pending_operations_cv.wait(lock);
 			}
 
+			// If no operation is enabled, then advance the virtual time to the earliest timer.
+			if (operations.size() == 0 && !timers.empty())
+			{
+				fire_next_timers();
+			}
+
 			// Check if the schedule has finished or if there is a deadlock.
 			if (operations.size() == 0)
 			{
@@ -973,6 +2186,7 @@ namespace coyote
 	#ifdef COYOTE_DEBUG_LOG
 					std::cout << "[coyote::schedule_next] deadlock detected" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
+					record_deadlock();
 					throw ErrorCode::DeadlockDetected;
 				}
 
@@ -982,19 +2196,37 @@ namespace coyote
 				throw ErrorCode::Success;
 			}
 
-			// Ask the strategy for the next operation to schedule.
-			size_t next_id = strategy->next_operation(operations, scheduled_op_id);
+			// Ask the strategy for the next operation to schedule, unless the iteration has exceeded its
+			// bounds, in which case the operations are scheduled fairly.
+			size_t next_id = check_iteration_bounds() ? next_fair_operation() :
+				strategy->next_operation(operations, scheduled_op_id);
 			Operation* next_op = operation_map.at(next_id).get();
+			if (next_op->status == OperationStatus::WaitResourceOrTimeout)
+			{
+				// The operation was scheduled before its resource was signaled, so its wait times out.
+				fire_timeout(next_op);
+			}
 
 			const size_t previous_id = scheduled_op_id;
 			scheduled_op_id = next_id;
 
+			const size_t concurrent_operations = operations.size() + operations.size(false);
+			current_iteration_statistics.record_step(operations.size(), concurrent_operations, previous_id != next_id);
+			accumulated_statistics.record_step(operations.size(), concurrent_operations, previous_id != next_id);
+			shared_statistics.publish(current_iteration_statistics, accumulated_statistics);
+
 	#ifdef COYOTE_DEBUG_LOG
 			std::cout << "[coyote::schedule_next] next operation " << next_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 
 			if (previous_id != next_id)
 			{
+				trace(TraceEventType::OperationScheduled, next_id, previous_id);
+				if (latency_profile != nullptr)
+				{
+					handoff_start_time = std::chrono::steady_clock::now();
+				}
+
 				// Resume the next operation.
 				next_op->is_scheduled = true;
 				next_op->cv.notify_all();
@@ -1011,18 +2243,381 @@ namespace coyote
 						std::cout << "[coyote::schedule_next] pausing operation " << previous_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 						// Wait until the operation gets scheduled again.
-						previous_op->cv.wait(lock);
+						pause_operation(previous_op, lock);
 	#ifdef COYOTE_DEBUG_LOG
 						std::cout << "[coyote::schedule_next] resuming operation " << previous_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
 						if (!is_attached)
 						{
-							throw ErrorCode::ClientNotAttached;
+							throw not_attached_error();
+						}
+						else if (previous_op->is_scheduled)
+						{
+							record_handoff();
+						}
+					}
+				}
+			}
+		}
+
+		// Records that a deadlock was detected while the current operation was scheduled.
+		void record_deadlock()
+		{
+			current_iteration_statistics.deadlocks++;
+			accumulated_statistics.deadlocks++;
+			shared_statistics.publish(current_iteration_statistics, accumulated_statistics);
+			trace(TraceEventType::DeadlockDetected, scheduled_op_id, 0);
+			strategy->on_bug_found();
+		}
+
+		// Checks if the specified operation, which has just blocked, closed a cycle of operations that wait
+		// for each other. Such operations can never be enabled again, even if other operations keep running,
+		// so the testing iteration ends with a deadlock.
+		void detect_wait_for_cycle(Operation* op)
+		{
+			if (!find_wait_for_cycle(op, deadlock_cycle_edges))
+			{
+				return;
+			}
+
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::detect_wait_for_cycle] deadlock of " << deadlock_cycle_edges.size()
+				<< " operations detected" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			record_deadlock();
+			end_iteration(ErrorCode::DeadlockDetected);
+			throw ErrorCode::DeadlockDetected;
+		}
+
+		// Searches the wait-for graph for a cycle through the specified operation, and assigns it to 'cycle'.
+		// Each blocked operation only has a few edges, and only the operations reachable from the specified
+		// one are visited, as any new cycle must pass through the operation that has just blocked.
+		bool find_wait_for_cycle(const Operation* op, std::vector<WaitForEdge>& cycle) const
+		{
+			std::vector<WaitForEdge> pending_edges;
+			add_wait_for_edges(op, pending_edges);
+
+			// Map from each reached operation id to the edge that first reached it.
+			std::unordered_map<size_t, WaitForEdge> reaching_edges;
+			while (!pending_edges.empty())
+			{
+				WaitForEdge edge = pending_edges.back();
+				pending_edges.pop_back();
+				if (edge.target_operation_id == op->id)
+				{
+					// Walk the edges back to the operation, which closes the cycle.
+					cycle.clear();
+					cycle.push_back(edge);
+					while (cycle.back().operation_id != op->id)
+					{
+						cycle.push_back(reaching_edges.at(cycle.back().operation_id));
+					}
+
+					std::reverse(cycle.begin(), cycle.end());
+					return true;
+				}
+				else if (reaching_edges.emplace(edge.target_operation_id, edge).second)
+				{
+					auto it = operation_map.find(edge.target_operation_id);
+					if (it != operation_map.end())
+					{
+						add_wait_for_edges(it->second.get(), pending_edges);
+					}
+				}
+			}
+
+			return false;
+		}
+
+		// Adds the edges of the wait-for graph that leave the specified operation. Only waits that can end
+		// solely when all target operations complete or release a lock are edges, so any cycle is a deadlock.
+		// Signals, timed waits and waits for any of several targets can be ended by other operations.
+		void add_wait_for_edges(const Operation* op, std::vector<WaitForEdge>& edges) const
+		{
+			if (op->has_timer)
+			{
+				return;
+			}
+			else if (op->status == OperationStatus::JoinAllOperations)
+			{
+				for (const auto& target_id : op->pending_operation_ids())
+				{
+					edges.push_back(WaitForEdge{ op->id, target_id, 0, true });
+				}
+			}
+			else if (op->status == OperationStatus::WaitAllResources)
+			{
+				for (const auto& resource_id : op->pending_resource_ids())
+				{
+					auto it = resource_map.find(resource_id);
+					if (it != resource_map.end())
+					{
+						const Resource* resource = it->second.get();
+						if (resource->is_lock && resource->owner_operation_id != Resource::no_owner_id &&
+							resource->is_acquiring(op->id))
+						{
+							edges.push_back(WaitForEdge{ op->id, resource->owner_operation_id, resource_id, false });
 						}
 					}
 				}
 			}
 		}
+
+		// Ends the current testing iteration early with the specified error, and releases all operations
+		// like 'detach' does. The released operations run uncontrolled, and their calls to the scheduler
+		// return the error, until the client detaches.
+		void end_iteration(ErrorCode error_code)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::end_iteration] releasing all operations" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			is_attached = false;
+			release_error_code = error_code;
+			last_error_code = error_code;
+			release_operations();
+		}
+
+		// Releases all operations, which stop being controlled and resume executing.
+		void release_operations()
+		{
+			// The main operation can be paused if another operation detaches, or if the iteration ends
+			// early, for example after a deadlock was detected, so release it as well.
+			Operation* main_op = operation_map.at(main_op_id).get();
+			main_op->status = OperationStatus::Completed;
+			main_op->is_scheduled = true;
+			operations.disable(main_op->id);
+			main_op->cv.notify_all();
+
+			for (auto& kvp : operation_map)
+			{
+				Operation* next_op = kvp.second.get();
+				if (next_op->status != OperationStatus::Completed)
+				{
+	#ifdef COYOTE_DEBUG_LOG
+					std::cout << "[coyote::release_operations] canceling operation " << next_op->id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+					// If the operation has not already completed, then cancel it.
+					next_op->is_scheduled = true;
+					next_op->status = OperationStatus::Completed;
+					operations.disable(next_op->id);
+					next_op->cv.notify_all();
+				}
+			}
+		}
+
+		// Returns the error of calling the scheduler while no client is attached, which is the error that
+		// ended the testing iteration early, if the operations were released before the client detached.
+		ErrorCode not_attached_error() const noexcept
+		{
+			return release_error_code != ErrorCode::Success ? release_error_code : ErrorCode::ClientNotAttached;
+		}
+
+		// Returns true if the current testing iteration has exceeded its step or time bound, in which case
+		// the next operation must be scheduled fairly. If the fair steps have also run out, then ends the
+		// iteration with a potential livelock.
+		bool check_iteration_bounds()
+		{
+			const size_t steps = current_iteration_statistics.steps;
+			if (!is_scheduling_fairly)
+			{
+				if ((max_iteration_steps == 0 || steps < max_iteration_steps) && (max_iteration_time.count() == 0 ||
+					std::chrono::steady_clock::now() - iteration_start_time < max_iteration_time))
+				{
+					return false;
+				}
+
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::schedule_next] iteration bounds exceeded after " << steps << " steps" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				is_scheduling_fairly = true;
+				fair_scheduling_start_step = steps;
+			}
+
+			if (steps - fair_scheduling_start_step >= fair_scheduling_steps)
+			{
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::schedule_next] potential livelock detected" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				trace(TraceEventType::PotentialLivelockDetected, scheduled_op_id, steps);
+				strategy->on_bug_found();
+				end_iteration(ErrorCode::PotentialLivelockDetected);
+				throw ErrorCode::PotentialLivelockDetected;
+			}
+
+			return true;
+		}
+
+		// Returns the enabled operation with the next higher id than the scheduled operation, wrapping around
+		// to the lowest id, so that each enabled operation is scheduled in turn.
+		size_t next_fair_operation()
+		{
+			bool has_next_id = false;
+			size_t next_id = 0;
+			size_t lowest_id = operations[0];
+			for (size_t index = 0; index < operations.size(); index++)
+			{
+				const size_t operation_id = operations[index];
+				if (operation_id > scheduled_op_id && (!has_next_id || operation_id < next_id))
+				{
+					has_next_id = true;
+					next_id = operation_id;
+				}
+
+				lowest_id = std::min(lowest_id, operation_id);
+			}
+
+			return has_next_id ? next_id : lowest_id;
+		}
+
+		// Pauses the calling thread until the specified operation is notified.
+		void pause_operation(Operation* op, std::unique_lock<std::mutex>& lock)
+		{
+			paused_operation_count++;
+			op->cv.wait(lock);
+			paused_operation_count--;
+			if (paused_operation_count == 0)
+			{
+				paused_operations_cv.notify_all();
+			}
+		}
+
+		// Advances the virtual time to the earliest timer deadline, and enables the operations whose
+		// timers fire at that deadline.
+		void fire_next_timers()
+		{
+			const std::chrono::nanoseconds deadline = timers.begin()->first;
+			current_virtual_time = deadline;
+			while (!timers.empty() && timers.begin()->first == deadline)
+			{
+				size_t operation_id = timers.begin()->second;
+				timers.erase(timers.begin());
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::schedule_next] firing timer of operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				fire_timeout(operation_map.at(operation_id).get());
+				operations.enable(operation_id);
+				strategy->on_operation_enabled(operation_id);
+			}
+		}
+
+		// Times out the wait of the specified operation, which stops waiting for any resources.
+		void fire_timeout(Operation* op)
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::schedule_next] timing out operation " << op->id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			for (const auto& resource_id : op->pending_resource_ids())
+			{
+				auto it = resource_map.find(resource_id);
+				if (it != resource_map.end())
+				{
+					it->second->remove_blocked_operation(op->id);
+				}
+			}
+
+			op->on_timer();
+			trace(TraceEventType::TimerFired, op->id, (size_t)current_virtual_time.count());
+		}
+
+		// Returns the epochs of the attaches in progress. Epochs are never reused, so a live epoch identifies
+		// a scheduler that still exists. The set is never deleted, so that schedulers with static storage
+		// duration can still be deleted after it at exit.
+		static std::unordered_set<uint64_t>& live_attach_epochs() noexcept
+		{
+			static std::unordered_set<uint64_t>* epochs = new std::unordered_set<uint64_t>();
+			return *epochs;
+		}
+
+		static void add_live_attach_epoch(uint64_t epoch)
+		{
+			std::unique_lock<std::mutex> lock(live_attach_epochs_mutex);
+			live_attach_epochs().insert(epoch);
+		}
+
+		static void remove_live_attach_epoch(uint64_t epoch) noexcept
+		{
+			std::unique_lock<std::mutex> lock(live_attach_epochs_mutex);
+			live_attach_epochs().erase(epoch);
+		}
+
+		// Returns the operation that the calling thread started in the current attach, else null.
+		Operation* current_operation() const noexcept
+		{
+			const OperationContext& context = thread_context;
+			if (context.scheduler != this || context.attach_epoch != attach_epoch || !is_attached)
+			{
+				return nullptr;
+			}
+
+			return context.operation;
+		}
+
+		// Returns the currently scheduled operation. This is usually the operation of the calling
+		// thread, which avoids looking it up in the operation map.
+		Operation* scheduled_operation()
+		{
+			Operation* op = current_operation();
+			if (op != nullptr && op->id == scheduled_op_id)
+			{
+				return op;
+			}
+
+			return operation_map.at(scheduled_op_id).get();
+		}
+
+		// Returns the resource with the specified id, or throws if it does not exist.
+		Resource* get_resource(size_t resource_id)
+		{
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			return it->second.get();
+		}
+
+		// Blocks the currently scheduled operation until it receives a permit of the specified resource,
+		// and returns the operation.
+		Operation* wait_permit(Resource* resource)
+		{
+			Operation* scheduled_op = scheduled_operation();
+			scheduled_op->wait_resource_signal(resource->id);
+			resource->acquiring_operation_ids.push_back(scheduled_op_id);
+			operations.disable(scheduled_op_id);
+			strategy->on_operation_blocked(scheduled_op_id);
+			trace(TraceEventType::OperationWaitingResource, scheduled_op_id, resource->id);
+			return scheduled_op;
+		}
+
+		// Cancels the timer of the specified operation, if it has one.
+		void cancel_timer(Operation* op)
+		{
+			if (op->has_timer)
+			{
+				timers.erase(std::make_pair(op->timer_deadline, op->id));
+				op->has_timer = false;
+			}
+		}
+
+		// Writes an event to the trace sink, if tracing is enabled.
+		void trace(TraceEventType type, size_t operation_id, size_t target_id)
+		{
+			if (trace_sink != nullptr)
+			{
+				trace_sink->write(TraceEvent{ type, 0, trace_sequence++, operation_id, target_id });
+			}
+		}
+
+		// Records the latency from notifying the next operation until it resumes executing.
+		void record_handoff() noexcept
+		{
+			if (latency_profile != nullptr)
+			{
+				latency_profile->record(LatencyEvent::Handoff, handoff_start_time);
+			}
+		}
 	};
 }
 
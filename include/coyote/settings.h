@@ -6,7 +6,10 @@
 
 #include <chrono>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 #include "strategies/strategy_type.h"
+#include "sync/atomic_density.h"
 
 namespace coyote
 {
@@ -19,13 +22,45 @@ namespace coyote
 		// A strategy-specific bound.
 		size_t strategy_bound;
 
+		// The upper strategy-specific bound, if the strategy adapts its bound across iterations.
+		size_t strategy_max_bound;
+
+		// True if the strategy adapts to the executions observed in previous iterations, else false.
+		bool is_strategy_adaptive;
+
 		// The seed used by randomized strategies.
 		uint64_t seed_state;
 
+		// The types and bounds of the strategies in the portfolio.
+		std::vector<std::pair<StrategyType, size_t>> portfolio;
+
+		// Which accesses of controlled atomics are scheduling points.
+		AtomicDensity atomic_density;
+
+		// The probability that an access of a controlled atomic is a scheduling point, if sampled.
+		size_t atomic_probability;
+
+		// The max number of scheduling steps of each testing iteration, or zero if unbounded.
+		size_t max_steps;
+
+		// The max wall-clock duration of each testing iteration, or zero if unbounded.
+		std::chrono::milliseconds max_time;
+
+		// The number of fairly scheduled steps after a bound is exceeded.
+		size_t fair_steps;
+
 	public:
 		Settings() noexcept :
 			strategy_type(StrategyType::Random),
-			seed_state(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+			strategy_bound(100),
+			strategy_max_bound(100),
+			is_strategy_adaptive(false),
+			seed_state(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
+			atomic_density(AtomicDensity::EveryAccess),
+			atomic_probability(100),
+			max_steps(0),
+			max_time(0),
+			fair_steps(0)
 		{
 		}
 
@@ -41,6 +76,8 @@ namespace coyote
 			strategy_type = StrategyType::Random;
 			seed_state = seed;
 			strategy_bound = 100;
+			strategy_max_bound = 100;
+			is_strategy_adaptive = false;
 		}
 
 		// Installs the random exploration strategy with the specified random seed and probability
@@ -54,6 +91,8 @@ namespace coyote
 			strategy_type = StrategyType::Random;
 			seed_state = seed;
 			strategy_bound = probability;
+			strategy_max_bound = probability;
+			is_strategy_adaptive = false;
 		}
 
 		// Installs the PCT exploration strategy with the specified random seed and priority switch bound.
@@ -62,6 +101,119 @@ namespace coyote
 			strategy_type = StrategyType::PCT;
 			seed_state = seed;
 			strategy_bound = bound;
+			strategy_max_bound = bound;
+			is_strategy_adaptive = false;
+		}
+
+		// Installs the PCT exploration strategy with the specified random seed in adaptive mode. The
+		// priority switch bound ramps up from min_bound to max_bound across iterations, giving each bound
+		// twice the iterations of the previous one. Priority change points are placed according to the
+		// distribution of schedule lengths observed in previous iterations, counting only the steps that
+		// had more than one enabled operation, and fall more often on the steps that had more of them.
+		void use_adaptive_pct_strategy(uint64_t seed, size_t min_bound, size_t max_bound)
+		{
+			if (min_bound > max_bound)
+			{
+				throw std::invalid_argument("received min bound greater than max bound");
+			}
+
+			strategy_type = StrategyType::PCT;
+			seed_state = seed;
+			strategy_bound = min_bound;
+			strategy_max_bound = max_bound;
+			is_strategy_adaptive = true;
+		}
+
+		// Installs the PCT exploration strategy with chain partitioning, with the specified random seed and
+		// priority switch bound.
+		void use_pctcp_strategy(uint64_t seed, size_t bound) noexcept
+		{
+			strategy_type = StrategyType::PCTCP;
+			seed_state = seed;
+			strategy_bound = bound;
+			strategy_max_bound = bound;
+			is_strategy_adaptive = false;
+		}
+
+		// Installs the Q-learning exploration strategy with the specified random seed.
+		void use_qlearning_strategy(uint64_t seed) noexcept
+		{
+			strategy_type = StrategyType::QLearning;
+			seed_state = seed;
+			strategy_bound = 0;
+			strategy_max_bound = 0;
+			is_strategy_adaptive = false;
+		}
+
+		// Installs the portfolio exploration strategy with the specified random seed. In each iteration,
+		// the portfolio selects one of the strategies added through 'add_portfolio_strategy', or one of
+		// a default set of random and PCT strategies if none were added.
+		void use_portfolio_strategy(uint64_t seed) noexcept
+		{
+			strategy_type = StrategyType::Portfolio;
+			seed_state = seed;
+			strategy_bound = 0;
+			strategy_max_bound = 0;
+			is_strategy_adaptive = false;
+		}
+
+		// Adds a strategy with the specified type and bound to the portfolio.
+		void add_portfolio_strategy(StrategyType type, size_t bound)
+		{
+			if (type == StrategyType::None || type == StrategyType::Portfolio)
+			{
+				throw std::invalid_argument("received a strategy type that cannot be part of a portfolio");
+			}
+			else if (type == StrategyType::Random && bound > 100)
+			{
+				throw std::invalid_argument("received probability greater than 100");
+			}
+
+			portfolio.push_back(std::make_pair(type, bound));
+		}
+
+		// Sets which accesses of controlled atomics are scheduling points. Fewer scheduling points explore
+		// coarser interleavings of lock-free code, but each iteration runs faster.
+		void use_atomic_density(AtomicDensity density) noexcept
+		{
+			atomic_density = density;
+			atomic_probability = 100;
+		}
+
+		// Makes each access of a controlled atomic a scheduling point with the specified probability.
+		void use_sampled_atomic_density(size_t probability)
+		{
+			if (probability > 100)
+			{
+				throw std::invalid_argument("received probability greater than 100");
+			}
+
+			atomic_density = AtomicDensity::Sampled;
+			atomic_probability = probability;
+		}
+
+		// Bounds the number of scheduling steps of each testing iteration, or removes the bound if zero.
+		// An iteration that exceeds the bound ends with 'ErrorCode::PotentialLivelockDetected', such as a
+		// spin or retry loop that never makes progress.
+		void bound_iteration_steps(size_t steps) noexcept
+		{
+			max_steps = steps;
+		}
+
+		// Bounds the wall-clock duration of each testing iteration, or removes the bound if zero. The bound
+		// is checked at scheduling steps, and an iteration that exceeds it ends like one that exceeds the
+		// step bound.
+		void bound_iteration_time(std::chrono::milliseconds time) noexcept
+		{
+			max_time = time;
+		}
+
+		// Schedules the enabled operations in round-robin order for the specified number of steps after an
+		// iteration exceeds its bound, before reporting a potential livelock. An iteration that completes
+		// during these fair steps only ran long, whereas a livelock persists under fair scheduling.
+		void use_fair_scheduling_suffix(size_t steps) noexcept
+		{
+			fair_steps = steps;
 		}
 
 		// Disables controlled scheduling.
@@ -82,11 +234,60 @@ namespace coyote
 			return strategy_bound;
 		}
 
+		// Returns the upper exploration strategy specific bound, which is the same as the bound unless
+		// the strategy is adaptive.
+		size_t exploration_strategy_max_bound() noexcept
+		{
+			return strategy_max_bound;
+		}
+
+		// Returns true if the exploration strategy adapts to previous iterations, else false.
+		bool is_exploration_strategy_adaptive() noexcept
+		{
+			return is_strategy_adaptive;
+		}
+
 		// Returns the seed used by randomized strategies.
 		uint64_t random_seed() noexcept
 		{
 			return seed_state;
 		}
+
+		// Returns which accesses of controlled atomics are scheduling points.
+		AtomicDensity atomic_scheduling_density() noexcept
+		{
+			return atomic_density;
+		}
+
+		// Returns the probability that an access of a controlled atomic is a scheduling point, if sampled.
+		size_t atomic_scheduling_probability() noexcept
+		{
+			return atomic_probability;
+		}
+
+		// Returns the max number of scheduling steps of each testing iteration, or zero if unbounded.
+		size_t max_iteration_steps() noexcept
+		{
+			return max_steps;
+		}
+
+		// Returns the max wall-clock duration of each testing iteration, or zero if unbounded.
+		std::chrono::milliseconds max_iteration_time() noexcept
+		{
+			return max_time;
+		}
+
+		// Returns the number of fairly scheduled steps after an iteration exceeds its bound.
+		size_t fair_scheduling_steps() noexcept
+		{
+			return fair_steps;
+		}
+
+		// Returns the types and bounds of the strategies in the portfolio.
+		const std::vector<std::pair<StrategyType, size_t>>& portfolio_strategies() noexcept
+		{
+			return portfolio;
+		}
 	};
 }
 
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_EXPLORATION_STATISTICS_H
+#define COYOTE_EXPLORATION_STATISTICS_H
+
+#include <cstddef>
+
+namespace coyote
+{
+	// Statistics about the explored schedules, either of a single testing iteration or accumulated
+	// across all testing iterations.
+	struct ExplorationStatistics
+	{
+		// Number of testing iterations.
+		size_t iterations;
+
+		// Number of scheduling steps, where the strategy chose the next operation.
+		size_t steps;
+
+		// Number of scheduling steps that switched to a different operation.
+		size_t context_switches;
+
+		// Number of detected deadlocks.
+		size_t deadlocks;
+
+		// Max number of started operations that had not completed at a scheduling step.
+		size_t max_concurrent_operations;
+
+		// Max number of enabled operations at a scheduling step.
+		size_t max_enabled_operations;
+
+		ExplorationStatistics() noexcept
+		{
+			clear();
+		}
+
+		// Records a scheduling step with the specified number of enabled and concurrent operations.
+		void record_step(size_t enabled_operations, size_t concurrent_operations, bool is_context_switch) noexcept
+		{
+			steps++;
+			if (is_context_switch)
+			{
+				context_switches++;
+			}
+
+			if (enabled_operations > max_enabled_operations)
+			{
+				max_enabled_operations = enabled_operations;
+			}
+
+			if (concurrent_operations > max_concurrent_operations)
+			{
+				max_concurrent_operations = concurrent_operations;
+			}
+		}
+
+		// Resets all statistics to zero.
+		void clear() noexcept
+		{
+			iterations = 0;
+			steps = 0;
+			context_switches = 0;
+			deadlocks = 0;
+			max_concurrent_operations = 0;
+			max_enabled_operations = 0;
+		}
+	};
+}
+
+#endif // COYOTE_EXPLORATION_STATISTICS_H
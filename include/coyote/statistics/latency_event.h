@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_LATENCY_EVENT_H
+#define COYOTE_LATENCY_EVENT_H
+
+namespace coyote
+{
+    enum class LatencyEvent
+    {
+        Attach = 0,
+        Detach,
+        CreateOperation,
+        StartOperation,
+        JoinOperation,
+        CompleteOperation,
+        WaitResource,
+        SignalResource,
+        ScheduleNext,
+        Handoff,
+        Sleep,
+        ExecuteBatch
+    };
+}
+
+#endif // COYOTE_LATENCY_EVENT_H
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_LATENCY_HISTOGRAM_H
+#define COYOTE_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+namespace coyote
+{
+	// Histogram of latencies in nanoseconds with logarithmic buckets, similar to an HDR histogram.
+	// Each power of two range is split into 16 linear sub-buckets, so recorded values are kept with
+	// a relative error of at most 1/16 across the whole 64-bit range. Recording is lock-free, so it
+	// can be done from any thread without holding the scheduler lock.
+	class LatencyHistogram
+	{
+	private:
+		static constexpr unsigned SUB_BUCKET_BITS = 4;
+		static constexpr uint64_t SUB_BUCKET_COUNT = (uint64_t)1 << SUB_BUCKET_BITS;
+		static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+		std::atomic<uint64_t> buckets[BUCKET_COUNT];
+		std::atomic<uint64_t> total_count;
+		std::atomic<uint64_t> total_sum;
+		std::atomic<uint64_t> min_value;
+		std::atomic<uint64_t> max_value;
+
+	public:
+		LatencyHistogram() noexcept
+		{
+			clear();
+		}
+
+		LatencyHistogram(LatencyHistogram&& histogram) = delete;
+		LatencyHistogram(LatencyHistogram const&) = delete;
+
+		LatencyHistogram& operator=(LatencyHistogram&& histogram) = delete;
+		LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+		// Records the specified latency in nanoseconds.
+		void record(uint64_t value) noexcept
+		{
+			buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+			total_count.fetch_add(1, std::memory_order_relaxed);
+			total_sum.fetch_add(value, std::memory_order_relaxed);
+
+			uint64_t current = min_value.load(std::memory_order_relaxed);
+			while (value < current && !min_value.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			{
+			}
+
+			current = max_value.load(std::memory_order_relaxed);
+			while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		// Returns the number of recorded latencies.
+		uint64_t count() const noexcept
+		{
+			return total_count.load(std::memory_order_relaxed);
+		}
+
+		// Returns the smallest recorded latency, or zero if there is none.
+		uint64_t min() const noexcept
+		{
+			return count() == 0 ? 0 : min_value.load(std::memory_order_relaxed);
+		}
+
+		// Returns the largest recorded latency, or zero if there is none.
+		uint64_t max() const noexcept
+		{
+			return max_value.load(std::memory_order_relaxed);
+		}
+
+		// Returns the mean of the recorded latencies, or zero if there is none.
+		double mean() const noexcept
+		{
+			uint64_t n = count();
+			return n == 0 ? 0 : (double)total_sum.load(std::memory_order_relaxed) / n;
+		}
+
+		// Returns the latency at the specified percentile in the [0, 100] range, rounded up to the
+		// upper bound of its bucket, or zero if there is none.
+		uint64_t percentile(double percentile) const noexcept
+		{
+			uint64_t n = count();
+			if (n == 0)
+			{
+				return 0;
+			}
+
+			uint64_t target = (uint64_t)std::ceil((percentile / 100) * n);
+			if (target == 0)
+			{
+				target = 1;
+			}
+
+			uint64_t seen = 0;
+			for (size_t idx = 0; idx < BUCKET_COUNT; idx++)
+			{
+				seen += buckets[idx].load(std::memory_order_relaxed);
+				if (seen >= target)
+				{
+					uint64_t value = bucket_upper_bound(idx);
+					return value < max() ? value : max();
+				}
+			}
+
+			return max();
+		}
+
+		// Removes all recorded latencies.
+		void clear() noexcept
+		{
+			for (size_t idx = 0; idx < BUCKET_COUNT; idx++)
+			{
+				buckets[idx].store(0, std::memory_order_relaxed);
+			}
+
+			total_count.store(0, std::memory_order_relaxed);
+			total_sum.store(0, std::memory_order_relaxed);
+			min_value.store(UINT64_MAX, std::memory_order_relaxed);
+			max_value.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		static size_t bucket_index(uint64_t value) noexcept
+		{
+			if (value < SUB_BUCKET_COUNT)
+			{
+				return (size_t)value;
+			}
+
+			unsigned msb = most_significant_bit(value);
+			unsigned shift = msb - SUB_BUCKET_BITS;
+			uint64_t sub_bucket = (value >> shift) & (SUB_BUCKET_COUNT - 1);
+			return (size_t)(((msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT) + sub_bucket);
+		}
+
+		static uint64_t bucket_upper_bound(size_t index) noexcept
+		{
+			if (index < SUB_BUCKET_COUNT)
+			{
+				return index;
+			}
+
+			unsigned msb = (unsigned)(index / SUB_BUCKET_COUNT) + SUB_BUCKET_BITS - 1;
+			unsigned shift = msb - SUB_BUCKET_BITS;
+			uint64_t lower = ((uint64_t)1 << msb) | ((uint64_t)(index % SUB_BUCKET_COUNT) << shift);
+			return lower + (((uint64_t)1 << shift) - 1);
+		}
+
+		static unsigned most_significant_bit(uint64_t value) noexcept
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return (unsigned)index;
+#else
+			return 63 - (unsigned)__builtin_clzll(value);
+#endif // _MSC_VER
+		}
+	};
+}
+
+#endif // COYOTE_LATENCY_HISTOGRAM_H
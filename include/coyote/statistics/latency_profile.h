@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_LATENCY_PROFILE_H
+#define COYOTE_LATENCY_PROFILE_H
+
+#include <chrono>
+#include "latency_event.h"
+#include "latency_histogram.h"
+
+namespace coyote
+{
+	// Latency histograms of the scheduler API calls and of the handoffs between operations.
+	class LatencyProfile
+	{
+	public:
+		// The number of latency events.
+		static constexpr size_t EVENT_COUNT = static_cast<size_t>(LatencyEvent::ExecuteBatch) + 1;
+
+	private:
+		LatencyHistogram histograms[EVENT_COUNT];
+
+	public:
+		LatencyProfile() noexcept
+		{
+		}
+
+		LatencyProfile(LatencyProfile&& profile) = delete;
+		LatencyProfile(LatencyProfile const&) = delete;
+
+		LatencyProfile& operator=(LatencyProfile&& profile) = delete;
+		LatencyProfile& operator=(LatencyProfile const&) = delete;
+
+		// Returns true if the specified event is one of the latency events, else false, such as for an
+		// event that was cast from an out of range integer.
+		static constexpr bool is_valid(LatencyEvent event) noexcept
+		{
+			return static_cast<size_t>(event) < EVENT_COUNT;
+		}
+
+		// Returns the histogram of the specified event, which must be valid.
+		LatencyHistogram& histogram(LatencyEvent event) noexcept
+		{
+			return histograms[static_cast<size_t>(event)];
+		}
+
+		// Records the time elapsed since the specified start time for the specified event.
+		void record(LatencyEvent event, std::chrono::steady_clock::time_point start_time) noexcept
+		{
+			auto elapsed = std::chrono::steady_clock::now() - start_time;
+			histogram(event).record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+
+		// Removes all recorded latencies.
+		void clear() noexcept
+		{
+			for (size_t idx = 0; idx < EVENT_COUNT; idx++)
+			{
+				histograms[idx].clear();
+			}
+		}
+	};
+
+	// Records the latency of the enclosing scope, if latency profiling is enabled.
+	class LatencyTimer
+	{
+	private:
+		LatencyProfile* profile;
+		LatencyEvent event;
+		std::chrono::steady_clock::time_point start_time;
+
+	public:
+		LatencyTimer(LatencyProfile* latency_profile, LatencyEvent latency_event) noexcept :
+			profile(latency_profile),
+			event(latency_event)
+		{
+			if (profile != nullptr)
+			{
+				start_time = std::chrono::steady_clock::now();
+			}
+		}
+
+		~LatencyTimer()
+		{
+			if (profile != nullptr)
+			{
+				profile->record(event, start_time);
+			}
+		}
+
+		LatencyTimer(LatencyTimer&& timer) = delete;
+		LatencyTimer(LatencyTimer const&) = delete;
+
+		LatencyTimer& operator=(LatencyTimer&& timer) = delete;
+		LatencyTimer& operator=(LatencyTimer const&) = delete;
+	};
+}
+
+#endif // COYOTE_LATENCY_PROFILE_H
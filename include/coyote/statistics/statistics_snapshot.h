@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_STATISTICS_SNAPSHOT_H
+#define COYOTE_STATISTICS_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include "exploration_statistics.h"
+
+namespace coyote
+{
+	// Exploration statistics with a fixed layout of lock-free atomic fields, in the same order as in
+	// 'ExplorationStatistics', so a host can read them directly from memory.
+	struct SharedExplorationStatistics
+	{
+		std::atomic<uint64_t> iterations;
+		std::atomic<uint64_t> steps;
+		std::atomic<uint64_t> context_switches;
+		std::atomic<uint64_t> deadlocks;
+		std::atomic<uint64_t> max_concurrent_operations;
+		std::atomic<uint64_t> max_enabled_operations;
+
+		void store(const ExplorationStatistics& statistics) noexcept
+		{
+			iterations.store(statistics.iterations, std::memory_order_relaxed);
+			steps.store(statistics.steps, std::memory_order_relaxed);
+			context_switches.store(statistics.context_switches, std::memory_order_relaxed);
+			deadlocks.store(statistics.deadlocks, std::memory_order_relaxed);
+			max_concurrent_operations.store(statistics.max_concurrent_operations, std::memory_order_relaxed);
+			max_enabled_operations.store(statistics.max_enabled_operations, std::memory_order_relaxed);
+		}
+
+		void load(ExplorationStatistics& statistics) const noexcept
+		{
+			statistics.iterations = (size_t)iterations.load(std::memory_order_relaxed);
+			statistics.steps = (size_t)steps.load(std::memory_order_relaxed);
+			statistics.context_switches = (size_t)context_switches.load(std::memory_order_relaxed);
+			statistics.deadlocks = (size_t)deadlocks.load(std::memory_order_relaxed);
+			statistics.max_concurrent_operations = (size_t)max_concurrent_operations.load(std::memory_order_relaxed);
+			statistics.max_enabled_operations = (size_t)max_enabled_operations.load(std::memory_order_relaxed);
+		}
+	};
+
+	// A snapshot of the statistics of the current testing iteration and of all testing iterations, which
+	// the scheduler publishes after each update so that a host can read them at any time without a call
+	// or a lock. The snapshot is versioned with a sequence lock: the scheduler makes the sequence odd
+	// before it updates the statistics, and even again after, so a copy is consistent if the sequence was
+	// even and did not change while the statistics were copied.
+	struct StatisticsSnapshot
+	{
+		// The version of the snapshot, which is odd while the scheduler updates it.
+		std::atomic<uint64_t> sequence;
+
+		// The statistics of the current, or last completed, testing iteration.
+		SharedExplorationStatistics iteration;
+
+		// The statistics accumulated across all testing iterations.
+		SharedExplorationStatistics total;
+
+		StatisticsSnapshot() noexcept
+		{
+			sequence.store(0, std::memory_order_relaxed);
+			publish(ExplorationStatistics(), ExplorationStatistics());
+		}
+
+		// Publishes the specified statistics. There must be a single writer at a time.
+		void publish(const ExplorationStatistics& iteration_statistics,
+			const ExplorationStatistics& total_statistics) noexcept
+		{
+			uint64_t version = sequence.load(std::memory_order_relaxed);
+			sequence.store(version + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			iteration.store(iteration_statistics);
+			total.store(total_statistics);
+			sequence.store(version + 2, std::memory_order_release);
+		}
+
+		// Copies a consistent version of the statistics, retrying while the scheduler updates them. This
+		// is the reader side of the snapshot, for hosts that are written in C++.
+		void read(ExplorationStatistics& iteration_statistics, ExplorationStatistics& total_statistics) const noexcept
+		{
+			while (true)
+			{
+				uint64_t version = sequence.load(std::memory_order_acquire);
+				if (version % 2 == 0)
+				{
+					iteration.load(iteration_statistics);
+					total.load(total_statistics);
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (sequence.load(std::memory_order_relaxed) == version)
+					{
+						return;
+					}
+				}
+			}
+		}
+	};
+
+	static_assert(sizeof(SharedExplorationStatistics) == 6 * sizeof(uint64_t),
+		"the shared statistics must have a fixed layout.");
+}
+
+#endif // COYOTE_STATISTICS_SNAPSHOT_H
@@ -4,10 +4,12 @@
 #ifndef COYOTE_PCT_STRATEGY_H
 #define COYOTE_PCT_STRATEGY_H
 
+#include <algorithm>
 #include <iostream>
-#include <list>
 #include <set>
-#include <unordered_set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "random.h"
 #include "strategy.h"
 #include "../error_code.h"
@@ -18,20 +20,58 @@ namespace coyote
 	class PCTStrategy : public Strategy
 	{
 	private:
+		// The priority of the first operation, which is scheduled first until the first priority
+		// change point.
+		static constexpr uint64_t INITIAL_PRIORITY = UINT64_MAX;
+
+		// Priorities lower than this value are reserved for operations that have been deprioritized.
+		static constexpr uint64_t MIN_RANDOM_PRIORITY = (uint64_t)1 << 32;
+
+		// The schedule length assumed in adaptive mode before any schedule length has been observed.
+		static constexpr size_t INITIAL_ADAPTIVE_SCHEDULE_LENGTH = 100;
+
+		// Max number of observed schedule lengths that are kept in adaptive mode.
+		static constexpr size_t MAX_OBSERVED_SCHEDULE_LENGTHS = 1024;
+
+		// Max number of choice steps whose enabled operations are counted in adaptive mode. Later choice
+		// steps are assumed to have the fewest possible enabled operations.
+		static constexpr size_t MAX_OBSERVED_CHOICE_STEPS = 1 << 16;
+
+		// The fewest enabled operations of a choice step.
+		static constexpr size_t MIN_CHOICE_STEP_OPERATIONS = 2;
+
 		// The pseudo-random generator.
 		Random generator;
 
+		// The seed with which the strategy was created.
+		const uint64_t initial_seed;
+
 		// The seed used by the current iteration.
 		uint64_t iteration_seed;
 
+		// Number of iterations explored so far, including the current one.
+		size_t iteration_count;
+
 		// Max number of priority switches during one iteration.
 		size_t max_priority_switches;
 
-		// List of prioritized operations.
-		std::list<size_t> prioritized_operations;
+		// True if the strategy adapts its bound and priority change points to previous iterations.
+		const bool is_adaptive;
 
-		// Set of operations with a known priority.
-		std::unordered_set<size_t> known_operations;
+		// The range of priority switch bounds that is cycled through in adaptive mode.
+		const size_t min_priority_switches_bound;
+		const size_t max_priority_switches_bound;
+
+		// Map from operations with a known priority to their priority, where higher values are
+		// scheduled first.
+		std::unordered_map<size_t, uint64_t> priorities;
+
+		// Set of enabled operations ordered by priority, which is maintained incrementally through
+		// the operation events, so that the highest priority operation is found in O(log n).
+		std::set<std::pair<uint64_t, size_t>> enabled_operations;
+
+		// The priority given to the next deprioritized operation.
+		uint64_t next_low_priority;
 
 		// Set of priority change points.
 		std::set<size_t> priority_change_points;
@@ -42,14 +82,47 @@ namespace coyote
 		// Approximate length of the schedule across all iterations.
 		size_t schedule_length;
 
+		// Number of scheduling steps with more than one enabled operation during the current iteration.
+		size_t choice_steps;
+
+		// Sample of the number of choice steps observed in previous iterations, which is used in
+		// adaptive mode to place the priority change points.
+		std::vector<size_t> observed_schedule_lengths;
+
+		// Number of iterations whose schedule length was observed.
+		size_t observed_iterations;
+
+		// Total number of enabled operations at each choice step across previous iterations, and the
+		// number of iterations that reached that choice step, which are used in adaptive mode to place
+		// the priority change points where the schedule has the most choices.
+		std::vector<uint64_t> choice_step_operations;
+		std::vector<uint64_t> choice_step_observations;
+
+		// Scratch buffer of cumulative priority change point weights, reused across iterations.
+		std::vector<double> change_point_weights;
+
 	public:
 		PCTStrategy(Settings* settings) noexcept :
 			generator(settings->random_seed()),
+			initial_seed(settings->random_seed()),
 			iteration_seed(settings->random_seed()),
+			iteration_count(1),
 			max_priority_switches(settings->exploration_strategy_bound()),
+			is_adaptive(settings->is_exploration_strategy_adaptive()),
+			min_priority_switches_bound(settings->exploration_strategy_bound()),
+			max_priority_switches_bound(settings->exploration_strategy_max_bound()),
+			next_low_priority(MIN_RANDOM_PRIORITY - 1),
 			scheduled_steps(0),
-			schedule_length(0)
+			schedule_length(0),
+			choice_steps(0),
+			observed_iterations(0)
 		{
+			if (is_adaptive)
+			{
+				// Unlike the default mode, the first iteration gets priority change points based on an
+				// initial guess of the schedule length.
+				choose_priority_change_points(INITIAL_ADAPTIVE_SCHEDULE_LENGTH);
+			}
 		}
 
 		PCTStrategy(PCTStrategy&& strategy) = delete;
@@ -61,11 +134,25 @@ namespace coyote
 		// Returns the next operation.
 		int next_operation(Operations& operations, size_t current)
 		{
-			set_new_operation_priorities(operations, current);
+			if (!is_synchronized(operations))
+			{
+				// The operation events were not reported, so synchronize with the enabled operations.
+				set_new_operation_priorities(operations, current);
+			}
+
 			try_deprioritize_operation_with_highest_priority(operations);
 			scheduled_steps++;
+			if (operations.size() > 1)
+			{
+				if (is_adaptive)
+				{
+					observe_choice_step(operations.size());
+				}
+
+				choice_steps++;
+			}
 
-			return (int)get_operation_with_highest_priority(operations);
+			return (int)get_operation_with_highest_priority();
 		}
 
 		// Returns the next boolean choice.
@@ -91,11 +178,17 @@ namespace coyote
 		// Prepares the next iteration.
 		void prepare_next_iteration(size_t iteration)
 		{
+			iteration_count = iteration;
+
 			// The first iteration has no knowledge of the execution, so only initialize from the second
 			// iteration and onwards. Note that although we could initialize the first length based on a
 			// heuristic, its not worth it, as the strategy will typically explore thousands of iterations,
 			// plus its also interesting to explore a schedule with no forced priority change points.
-			if (iteration > 1)
+			if (is_adaptive)
+			{
+				prepare_next_adaptive_iteration(iteration);
+			}
+			else if (iteration > 1)
 			{
 				if (schedule_length < scheduled_steps)
 				{
@@ -103,50 +196,132 @@ namespace coyote
 				}
 
 				scheduled_steps = 0;
+				next_low_priority = MIN_RANDOM_PRIORITY - 1;
 
-				prioritized_operations.clear();
-				known_operations.clear();
+				priorities.clear();
+				enabled_operations.clear();
 				priority_change_points.clear();
 
 				shuffle_priority_change_points();
 			}
 		}
 
+		// Returns the type of this strategy.
+		StrategyType exploration_strategy()
+		{
+			return StrategyType::PCT;
+		}
+
+		// Returns the max number of priority switches during one iteration.
+		size_t exploration_strategy_bound()
+		{
+			return max_priority_switches;
+		}
+
+		// Returns the seed with which this strategy was created.
+		uint64_t exploration_strategy_seed()
+		{
+			return initial_seed;
+		}
+
+		// Returns the number of iterations explored so far, including the current one.
+		size_t exploration_strategy_iteration()
+		{
+			return iteration_count;
+		}
+
+		// Assigns a random priority to the new operation.
+		void on_operation_created(size_t operation_id, size_t /* group_id */)
+		{
+			// An operation id can be reused after the operation completes, so always assign a new priority.
+			on_operation_completed(operation_id);
+			priorities.erase(operation_id);
+			assign_priority(operation_id);
+		}
+
+		// Adds the operation to the set of enabled operations.
+		void on_operation_enabled(size_t operation_id)
+		{
+			enabled_operations.insert(std::make_pair(assign_priority(operation_id), operation_id));
+		}
+
+		// Removes the operation from the set of enabled operations.
+		void on_operation_blocked(size_t operation_id)
+		{
+			on_operation_completed(operation_id);
+		}
+
+		// Removes the operation from the set of enabled operations.
+		void on_operation_completed(size_t operation_id)
+		{
+			auto it = priorities.find(operation_id);
+			if (it != priorities.end())
+			{
+				enabled_operations.erase(std::make_pair(it->second, operation_id));
+			}
+		}
+
 	private:
-		// Sets the priority of new operations, if there are any.
-		void set_new_operation_priorities(Operations& operations, size_t current)
+		// Returns the priority of the operation, assigning a random one if it does not have a priority.
+		uint64_t assign_priority(size_t operation_id)
 		{
-			if (prioritized_operations.size() == 0)
+			auto it = priorities.find(operation_id);
+			if (it != priorities.end())
 			{
-				prioritized_operations.push_back(current);
-				known_operations.insert(current);
+				return it->second;
+			}
+
+			// The first operation has the highest priority, and the rest get a random priority below it.
+			uint64_t priority = INITIAL_PRIORITY;
+			if (!priorities.empty())
+			{
+				priority = MIN_RANDOM_PRIORITY + (generator.next() % (INITIAL_PRIORITY - MIN_RANDOM_PRIORITY));
+			}
+
+			priorities.insert(std::make_pair(operation_id, priority));
 	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::pct] assigning priority 0 for operation " << current << std::endl;
+			std::cout << "[coyote::pct] assigning priority " << priority << " for operation " << operation_id << std::endl;
 	#endif // COYOTE_DEBUG_LOG
+			return priority;
+		}
+
+		// Returns true if the enabled operations reported through the operation events are exactly the
+		// specified enabled operations, else false. Comparing only the counts would miss an operation that
+		// was enabled in place of another one without being reported.
+		bool is_synchronized(Operations& operations)
+		{
+			if (enabled_operations.size() != operations.size())
+			{
+				return false;
 			}
 
-			// Randomize the priority of all new operations.
 			for (size_t idx = 0; idx < operations.size(); idx++)
 			{
-				size_t next_op = operations[idx];
-
-				// Check if the priority of the operation is already assigned.
-				auto it = known_operations.find(next_op);
-				if (it == known_operations.end())
+				auto it = priorities.find(operations[idx]);
+				if (it == priorities.end() || enabled_operations.count(std::make_pair(it->second, it->first)) == 0)
 				{
-					// Randomly choose a priority for this operation.
-					auto index = (generator.next() % prioritized_operations.size()) + 1;
-					auto it = prioritized_operations.begin();
-					std::advance(it, index);
-					prioritized_operations.insert(it, next_op);
-					known_operations.insert(next_op);
-	#ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::pct] assigning priority " << index << " for operation " << next_op << std::endl;
-	#endif // COYOTE_DEBUG_LOG
+					return false;
 				}
 			}
+
+			return true;
+		}
+
+		// Sets the priority of new operations, if there are any, and rebuilds the set of enabled operations.
+		void set_new_operation_priorities(Operations& operations, size_t current)
+		{
+			if (priorities.empty())
+			{
+				assign_priority(current);
+			}
+
+			enabled_operations.clear();
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				on_operation_enabled(operations[idx]);
+			}
 		}
-		
+
 		// Deprioritizes the operation with the highest priority, if there is a priority change point.
 		bool try_deprioritize_operation_with_highest_priority(Operations& operations)
 		{
@@ -156,16 +331,17 @@ namespace coyote
 				return false;
 			}
 
-			auto it = priority_change_points.find(scheduled_steps);
+			auto it = priority_change_points.find(is_adaptive ? choice_steps : scheduled_steps);
 			if (it == priority_change_points.end())
 			{
 				return false;
 			}
 
-			// Deprioritize the operation by putting it in the end of the list.
-			size_t op = get_operation_with_highest_priority(operations);
-			prioritized_operations.remove(op);
-			prioritized_operations.push_back(op);
+			// Deprioritize the operation by giving it a priority lower than all other operations.
+			size_t op = get_operation_with_highest_priority();
+			on_operation_completed(op);
+			priorities[op] = next_low_priority--;
+			on_operation_enabled(op);
 	#ifdef COYOTE_DEBUG_LOG
 			std::cout << "[coyote::pct] operation " << op << " is deprioritized" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
@@ -173,21 +349,104 @@ namespace coyote
 		}
 
 		// Returns the operation with the highest priority.
-		size_t get_operation_with_highest_priority(Operations& operations)
+		size_t get_operation_with_highest_priority()
 		{
-			for (auto it = prioritized_operations.begin(); it != prioritized_operations.end(); it++)
+			if (enabled_operations.empty())
+			{
+				throw ErrorCode::InternalError;
+			}
+
+			return enabled_operations.rbegin()->second;
+		}
+
+		// Prepares the next iteration in adaptive mode.
+		void prepare_next_adaptive_iteration(size_t iteration)
+		{
+			// Keep a uniform sample of the observed schedule lengths using reservoir sampling.
+			observed_iterations++;
+			if (observed_schedule_lengths.size() < MAX_OBSERVED_SCHEDULE_LENGTHS)
+			{
+				observed_schedule_lengths.push_back(choice_steps);
+			}
+			else
 			{
-				for (size_t idx = 0; idx < operations.size(); idx++)
+				size_t idx = generator.next() % observed_iterations;
+				if (idx < MAX_OBSERVED_SCHEDULE_LENGTHS)
 				{
-					size_t next_op = operations[idx];
-					if (*it == next_op)
-					{
-						return next_op;
-					}
+					observed_schedule_lengths[idx] = choice_steps;
 				}
 			}
 
-			throw ErrorCode::InternalError;
+			scheduled_steps = 0;
+			choice_steps = 0;
+			next_low_priority = MIN_RANDOM_PRIORITY - 1;
+
+			priorities.clear();
+			enabled_operations.clear();
+			priority_change_points.clear();
+
+			// Ramp the bound up through the configured range, giving each bound twice the iterations of the
+			// previous one, as finding a bug of one more depth takes a multiple of the iterations, and keep
+			// the max bound once it is reached.
+			size_t ramp = 0;
+			for (size_t remaining = iteration; remaining > 1; remaining >>= 1)
+			{
+				ramp++;
+			}
+
+			max_priority_switches = std::min(min_priority_switches_bound + ramp, max_priority_switches_bound);
+
+			// Sample the length of the next schedule from the observed lengths, so that the change points
+			// are spread over schedules the program actually produces instead of only the longest one.
+			size_t length = observed_schedule_lengths[generator.next() % observed_schedule_lengths.size()];
+			choose_priority_change_points(length);
+		}
+
+		// Counts the specified number of enabled operations at the current choice step.
+		void observe_choice_step(size_t enabled_operations_count)
+		{
+			if (choice_steps < MAX_OBSERVED_CHOICE_STEPS)
+			{
+				if (choice_steps == choice_step_operations.size())
+				{
+					choice_step_operations.push_back(0);
+					choice_step_observations.push_back(0);
+				}
+
+				choice_step_operations[choice_steps] += enabled_operations_count;
+				choice_step_observations[choice_steps]++;
+			}
+		}
+
+		// Chooses distinct random priority change points in the [0, length) range, where each choice step
+		// is weighted by the mean number of enabled operations observed at it, so that the points fall
+		// more often where the schedule has more choices.
+		void choose_priority_change_points(size_t length)
+		{
+			change_point_weights.clear();
+			double total_weight = 0;
+			for (size_t step = 0; step < length; step++)
+			{
+				total_weight += step < choice_step_operations.size() ?
+					(double)choice_step_operations[step] / choice_step_observations[step] :
+					(double)MIN_CHOICE_STEP_OPERATIONS;
+				change_point_weights.push_back(total_weight);
+			}
+
+			size_t count = std::min(max_priority_switches, length);
+			while (priority_change_points.size() < count)
+			{
+				double value = (double)(generator.next() >> 11) / (double)(1ULL << 53) * total_weight;
+				size_t point = std::upper_bound(change_point_weights.begin(), change_point_weights.end(), value) -
+					change_point_weights.begin();
+				point = std::min(point, length - 1);
+				if (priority_change_points.insert(point).second)
+				{
+	#ifdef COYOTE_DEBUG_LOG
+					std::cout << "[coyote::pct] assigning priority change at " << point << " choice step" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				}
+			}
 		}
 
 		// Shuffles the priority change points using the Fisher-Yates algorithm.
@@ -195,7 +454,8 @@ namespace coyote
 		{
 			if (schedule_length > 1)
 			{
-				std::list<size_t> range;
+				std::vector<size_t> range;
+				range.reserve(schedule_length - 1);
 				for (size_t i = 1; i < schedule_length; i++)
 				{
 					range.push_back(i);
@@ -204,14 +464,7 @@ namespace coyote
 				for (size_t idx = range.size() - 1; idx >= 1; idx--)
 				{
 					size_t point = generator.next() % range.size();
-
-					std::list<size_t>::iterator idx_it = range.begin();
-					std::advance(idx_it, idx);
-
-					std::list<size_t>::iterator point_it = range.begin();
-					std::advance(point_it, point);
-
-					std::iter_swap(idx_it, point_it);
+					std::swap(range[idx], range[point]);
 				}
 
 				size_t count = max_priority_switches;
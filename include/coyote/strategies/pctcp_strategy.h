@@ -0,0 +1,447 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PCTCP_STRATEGY_H
+#define COYOTE_PCTCP_STRATEGY_H
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "random.h"
+#include "strategy.h"
+#include "../error_code.h"
+#include "../settings.h"
+#include "../operations/operation.h"
+
+namespace coyote
+{
+	// Variant of the PCT strategy with chain partitioning. Operations are grouped into chains and
+	// priorities are assigned to chains instead of operations, so the probability of hitting a bug
+	// depends on the number of chains rather than on the number of operations.
+	//
+	// Operations created with the same group id belong to the same chain. An operation created without
+	// a group continues a chain whose operations have all completed, which keeps the number of chains
+	// close to the max number of concurrently running operations. Within a chain, the enabled operation
+	// that was created first is scheduled.
+	class PCTCPStrategy : public Strategy
+	{
+	private:
+		// A chain of operations that shares a priority.
+		struct Chain
+		{
+			// The priority of the chain, where higher values are scheduled first.
+			uint64_t priority;
+
+			// Number of operations in the chain that have not completed.
+			size_t live_operations;
+
+			// True if the chain belongs to an explicit group, else false.
+			bool is_grouped;
+
+			// Map from the creation order of the enabled operations in the chain to their ids.
+			std::map<size_t, size_t> enabled_operations;
+		};
+
+		// The chain and creation order of an operation.
+		struct OperationInfo
+		{
+			size_t chain;
+			size_t sequence;
+		};
+
+		// The priority of the chain of the first operation, which is scheduled first until the first
+		// priority change point, as in the PCT strategy.
+		static constexpr uint64_t INITIAL_PRIORITY = UINT64_MAX;
+
+		// Priorities lower than this value are reserved for chains that have been deprioritized.
+		static constexpr uint64_t MIN_RANDOM_PRIORITY = (uint64_t)1 << 32;
+
+		// The pseudo-random generator.
+		Random generator;
+
+		// The seed with which the strategy was created.
+		const uint64_t initial_seed;
+
+		// The seed used by the current iteration.
+		uint64_t iteration_seed;
+
+		// Number of iterations explored so far, including the current one.
+		size_t iteration_count;
+
+		// Max number of priority switches during one iteration.
+		size_t max_priority_switches;
+
+		// The chains of the current iteration.
+		std::vector<Chain> chains;
+
+		// Map from group ids to chains.
+		std::unordered_map<size_t, size_t> group_chains;
+
+		// Ungrouped chains whose operations have all completed, which can be continued.
+		std::vector<size_t> free_chains;
+
+		// Map from operation ids to their chain and creation order.
+		std::unordered_map<size_t, OperationInfo> operation_infos;
+
+		// Number of operations created during the current iteration.
+		size_t created_operations;
+
+		// Set of chains with enabled operations ordered by priority, which is maintained incrementally
+		// through the operation events, so that the highest priority operation is found in O(log n).
+		std::set<std::pair<uint64_t, size_t>> enabled_chains;
+
+		// Number of enabled operations across all chains.
+		size_t enabled_operations_count;
+
+		// The priority given to the next deprioritized chain.
+		uint64_t next_low_priority;
+
+		// Set of priority change points.
+		std::set<size_t> priority_change_points;
+
+		// Number of scheduling steps during the current iteration.
+		size_t scheduled_steps;
+
+		// Approximate length of the schedule across all iterations.
+		size_t schedule_length;
+
+	public:
+		PCTCPStrategy(Settings* settings) noexcept :
+			generator(settings->random_seed()),
+			initial_seed(settings->random_seed()),
+			iteration_seed(settings->random_seed()),
+			iteration_count(1),
+			max_priority_switches(settings->exploration_strategy_bound()),
+			created_operations(0),
+			enabled_operations_count(0),
+			next_low_priority(MIN_RANDOM_PRIORITY - 1),
+			scheduled_steps(0),
+			schedule_length(0)
+		{
+		}
+
+		PCTCPStrategy(PCTCPStrategy&& strategy) = delete;
+		PCTCPStrategy(PCTCPStrategy const&) = delete;
+
+		PCTCPStrategy& operator=(PCTCPStrategy&& strategy) = delete;
+		PCTCPStrategy& operator=(PCTCPStrategy const&) = delete;
+
+		// Returns the next operation.
+		int next_operation(Operations& operations, size_t current)
+		{
+			if (chains.empty())
+			{
+				// The current operation gets the initial priority.
+				on_operation_created(current, Operation::ungrouped_id);
+			}
+
+			if (!is_synchronized(operations))
+			{
+				// The operation events were not reported, so synchronize with the enabled operations.
+				set_enabled_operations(operations);
+			}
+
+			if (operations.size() > 1 && priority_change_points.find(scheduled_steps) != priority_change_points.end())
+			{
+				// Deprioritize the chain with the highest priority.
+				size_t chain = get_chain_with_highest_priority();
+				set_chain_priority(chain, next_low_priority--);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::pctcp] chain " << chain << " is deprioritized" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			}
+
+			scheduled_steps++;
+			return (int)chains[get_chain_with_highest_priority()].enabled_operations.begin()->second;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			scheduled_steps++;
+			return generator.next() & 1;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			scheduled_steps++;
+			return generator.next() % max_value;
+		}
+
+		// Returns the seed used in the current iteration.
+		uint64_t random_seed()
+		{
+			return iteration_seed;
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t iteration)
+		{
+			iteration_count = iteration;
+
+			// As in the PCT strategy, the first iteration explores a schedule with no priority change
+			// points, and is used to learn the approximate length of the schedule.
+			if (iteration > 1)
+			{
+				if (schedule_length < scheduled_steps)
+				{
+					schedule_length = scheduled_steps;
+				}
+
+				scheduled_steps = 0;
+				created_operations = 0;
+				next_low_priority = MIN_RANDOM_PRIORITY - 1;
+
+				chains.clear();
+				group_chains.clear();
+				free_chains.clear();
+				operation_infos.clear();
+				enabled_chains.clear();
+				enabled_operations_count = 0;
+				priority_change_points.clear();
+
+				choose_priority_change_points();
+			}
+		}
+
+		// Returns the type of this strategy.
+		StrategyType exploration_strategy()
+		{
+			return StrategyType::PCTCP;
+		}
+
+		// Returns the max number of priority switches during one iteration.
+		size_t exploration_strategy_bound()
+		{
+			return max_priority_switches;
+		}
+
+		// Returns the seed with which this strategy was created.
+		uint64_t exploration_strategy_seed()
+		{
+			return initial_seed;
+		}
+
+		// Returns the number of iterations explored so far, including the current one.
+		size_t exploration_strategy_iteration()
+		{
+			return iteration_count;
+		}
+
+		// Assigns the new operation to a chain.
+		void on_operation_created(size_t operation_id, size_t group_id)
+		{
+			// An operation id can be reused after the operation completes.
+			on_operation_completed(operation_id);
+
+			size_t chain;
+			if (group_id != Operation::ungrouped_id)
+			{
+				auto it = group_chains.find(group_id);
+				if (it == group_chains.end())
+				{
+					chain = create_chain(true);
+					group_chains.insert(std::make_pair(group_id, chain));
+				}
+				else
+				{
+					chain = it->second;
+				}
+			}
+			else if (!free_chains.empty())
+			{
+				chain = free_chains.back();
+				free_chains.pop_back();
+			}
+			else
+			{
+				chain = create_chain(false);
+			}
+
+			chains[chain].live_operations++;
+			operation_infos[operation_id] = OperationInfo{ chain, created_operations++ };
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::pctcp] assigning chain " << chain << " to operation " << operation_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+		}
+
+		// Adds the operation to the enabled operations of its chain.
+		void on_operation_enabled(size_t operation_id)
+		{
+			const OperationInfo& info = get_operation_info(operation_id);
+			Chain& chain = chains[info.chain];
+			if (chain.enabled_operations.insert(std::make_pair(info.sequence, operation_id)).second)
+			{
+				if (chain.enabled_operations.size() == 1)
+				{
+					enabled_chains.insert(std::make_pair(chain.priority, info.chain));
+				}
+
+				enabled_operations_count++;
+			}
+		}
+
+		// Removes the operation from the enabled operations of its chain.
+		void on_operation_blocked(size_t operation_id)
+		{
+			auto it = operation_infos.find(operation_id);
+			if (it != operation_infos.end())
+			{
+				Chain& chain = chains[it->second.chain];
+				if (chain.enabled_operations.erase(it->second.sequence) > 0)
+				{
+					if (chain.enabled_operations.empty())
+					{
+						enabled_chains.erase(std::make_pair(chain.priority, it->second.chain));
+					}
+
+					enabled_operations_count--;
+				}
+			}
+		}
+
+		// Removes the completed operation from its chain.
+		void on_operation_completed(size_t operation_id)
+		{
+			on_operation_blocked(operation_id);
+			auto it = operation_infos.find(operation_id);
+			if (it != operation_infos.end())
+			{
+				Chain& chain = chains[it->second.chain];
+				chain.live_operations--;
+				if (chain.live_operations == 0 && !chain.is_grouped)
+				{
+					free_chains.push_back(it->second.chain);
+				}
+
+				operation_infos.erase(it);
+			}
+		}
+
+		// Returns the number of chains created during the current iteration.
+		size_t chains_count()
+		{
+			return chains.size();
+		}
+
+	private:
+		size_t create_chain(bool is_grouped)
+		{
+			// The first chain has the highest priority, and the rest get a random priority below it.
+			uint64_t priority = INITIAL_PRIORITY;
+			if (!chains.empty())
+			{
+				priority = MIN_RANDOM_PRIORITY + (generator.next() % (INITIAL_PRIORITY - MIN_RANDOM_PRIORITY));
+			}
+
+			chains.push_back(Chain{ priority, 0, is_grouped, {} });
+			return chains.size() - 1;
+		}
+
+		const OperationInfo& get_operation_info(size_t operation_id)
+		{
+			auto it = operation_infos.find(operation_id);
+			if (it == operation_infos.end())
+			{
+				// The scheduler did not report the creation of this operation, so add it to a chain now.
+				on_operation_created(operation_id, Operation::ungrouped_id);
+				it = operation_infos.find(operation_id);
+			}
+
+			return it->second;
+		}
+
+		// Returns true if the enabled operations reported through the operation events are exactly the
+		// specified enabled operations, else false.
+		bool is_synchronized(Operations& operations)
+		{
+			if (enabled_operations_count != operations.size())
+			{
+				return false;
+			}
+
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				auto it = operation_infos.find(operations[idx]);
+				if (it == operation_infos.end())
+				{
+					return false;
+				}
+
+				const std::map<size_t, size_t>& chain_operations = chains[it->second.chain].enabled_operations;
+				if (chain_operations.find(it->second.sequence) == chain_operations.end())
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// Sets the enabled operations of the chains to the specified operations.
+		void set_enabled_operations(Operations& operations)
+		{
+			for (Chain& chain : chains)
+			{
+				chain.enabled_operations.clear();
+			}
+
+			enabled_chains.clear();
+			enabled_operations_count = 0;
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				on_operation_enabled(operations[idx]);
+			}
+		}
+
+		// Assigns the specified priority to the specified chain.
+		void set_chain_priority(size_t chain_idx, uint64_t priority)
+		{
+			Chain& chain = chains[chain_idx];
+			if (!chain.enabled_operations.empty())
+			{
+				enabled_chains.erase(std::make_pair(chain.priority, chain_idx));
+				enabled_chains.insert(std::make_pair(priority, chain_idx));
+			}
+
+			chain.priority = priority;
+		}
+
+		// Returns the chain with the highest priority among the chains with enabled operations. The
+		// first created enabled operation in that chain is the operation with the highest priority.
+		size_t get_chain_with_highest_priority()
+		{
+			if (enabled_chains.empty())
+			{
+				throw ErrorCode::InternalError;
+			}
+
+			return enabled_chains.rbegin()->second;
+		}
+
+		// Chooses distinct random priority change points in the [1, schedule_length) range.
+		void choose_priority_change_points()
+		{
+			if (schedule_length > 1)
+			{
+				size_t count = std::min(max_priority_switches, schedule_length - 1);
+				while (priority_change_points.size() < count)
+				{
+					size_t point = 1 + (generator.next() % (schedule_length - 1));
+					if (priority_change_points.insert(point).second)
+					{
+	#ifdef COYOTE_DEBUG_LOG
+						std::cout << "[coyote::pctcp] assigning priority change at " << point << " step" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+					}
+				}
+			}
+		}
+	};
+}
+
+#endif // COYOTE_PCTCP_STRATEGY_H
@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PORTFOLIO_STRATEGY_H
+#define COYOTE_PORTFOLIO_STRATEGY_H
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "pct_strategy.h"
+#include "pctcp_strategy.h"
+#include "qlearning_strategy.h"
+#include "random_strategy.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Strategy that holds a portfolio of configured strategies and selects one of them in each iteration
+	// using the UCB1 multi-armed bandit algorithm. An iteration is rewarded if it found a bug or covered
+	// an interleaving edge, a context switch from one operation to another, that no earlier iteration
+	// covered. The number of edges is bounded, so this reward fades once the reachable interleavings
+	// are covered, and the portfolio spends more iterations on the strategies that keep discovering new
+	// behaviors in the program under test.
+	//
+	// The selected strategy explores the whole iteration, and its choices only depend on the iterations
+	// that it explored itself. A buggy iteration can thus be reproduced by installing that strategy alone
+	// with the type, bound and seed reported by 'exploration_strategy', 'exploration_strategy_bound' and
+	// 'exploration_strategy_seed', and running it until the iteration reported by
+	// 'exploration_strategy_iteration'.
+	class PortfolioStrategy : public Strategy
+	{
+	private:
+		// A strategy in the portfolio, with its bandit statistics.
+		struct Arm
+		{
+			// Settings used to create the strategy.
+			std::unique_ptr<Settings> settings;
+
+			// The strategy.
+			std::unique_ptr<Strategy> strategy;
+
+			// Number of iterations explored by this strategy.
+			size_t iterations;
+
+			// Sum of the rewards received by this strategy.
+			double total_reward;
+		};
+
+		// The reward of an iteration that covered a new interleaving edge.
+		static constexpr double COVERAGE_REWARD = 0.5;
+
+		// The reward of an iteration that found a bug.
+		static constexpr double BUG_REWARD = 1;
+
+		// The strategies in the portfolio.
+		std::vector<Arm> arms;
+
+		// The index of the strategy that explores the current iteration.
+		size_t current_arm;
+
+		// Number of iterations explored by the portfolio.
+		size_t total_iterations;
+
+		// True if the current iteration covered a new interleaving edge, else false.
+		bool is_new_edge_covered;
+
+		// True if a bug was found in the current iteration, else false.
+		bool is_bug_found;
+
+		// Keys of the interleaving edges covered by all iterations.
+		std::unordered_set<uint64_t> covered_edges;
+
+	public:
+		PortfolioStrategy(Settings* settings) :
+			current_arm(0),
+			total_iterations(1),
+			is_new_edge_covered(false),
+			is_bug_found(false)
+		{
+			const uint64_t seed = settings->random_seed();
+			if (settings->portfolio_strategies().empty())
+			{
+				add_strategy(StrategyType::Random, 100, seed);
+				add_strategy(StrategyType::Random, 10, seed);
+				add_strategy(StrategyType::PCT, 3, seed);
+				add_strategy(StrategyType::PCT, 10, seed);
+			}
+			else
+			{
+				for (const auto& config : settings->portfolio_strategies())
+				{
+					add_strategy(config.first, config.second, seed);
+				}
+			}
+
+			arms[current_arm].iterations = 1;
+		}
+
+		PortfolioStrategy(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy(PortfolioStrategy const&) = delete;
+
+		PortfolioStrategy& operator=(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy& operator=(PortfolioStrategy const&) = delete;
+
+		// Returns the next operation.
+		int next_operation(Operations& operations, size_t current)
+		{
+			int next_op = arms[current_arm].strategy->next_operation(operations, current);
+			if ((size_t)next_op != current)
+			{
+				cover_edge(current, (size_t)next_op);
+			}
+
+			return next_op;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return arms[current_arm].strategy->next_boolean();
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return arms[current_arm].strategy->next_integer(max_value);
+		}
+
+		// Returns the seed used in the current iteration by the selected strategy.
+		uint64_t random_seed()
+		{
+			return arms[current_arm].strategy->random_seed();
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t /* iteration */)
+		{
+			double reward = 0;
+			if (is_bug_found)
+			{
+				reward = BUG_REWARD;
+			}
+			else if (is_new_edge_covered)
+			{
+				reward = COVERAGE_REWARD;
+			}
+
+			arms[current_arm].total_reward += reward;
+
+			current_arm = select_arm();
+			is_new_edge_covered = false;
+			is_bug_found = false;
+			total_iterations++;
+
+			Arm& arm = arms[current_arm];
+			arm.iterations++;
+			if (arm.iterations > 1)
+			{
+				// The scheduler does not prepare the first iteration of a strategy, so neither do we.
+				arm.strategy->prepare_next_iteration(arm.iterations);
+			}
+
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::portfolio] selecting strategy " << current_arm << " with seed " <<
+				arm.strategy->random_seed() << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+		}
+
+		// Returns the type of the strategy that explores the current iteration.
+		StrategyType exploration_strategy()
+		{
+			return arms[current_arm].strategy->exploration_strategy();
+		}
+
+		// Returns the bound of the strategy that explores the current iteration.
+		size_t exploration_strategy_bound()
+		{
+			return arms[current_arm].strategy->exploration_strategy_bound();
+		}
+
+		// Returns the seed with which the strategy that explores the current iteration was created.
+		uint64_t exploration_strategy_seed()
+		{
+			return arms[current_arm].strategy->exploration_strategy_seed();
+		}
+
+		// Returns the number of iterations, including the current one, that have been explored by the
+		// strategy that explores the current iteration.
+		size_t exploration_strategy_iteration()
+		{
+			return arms[current_arm].iterations;
+		}
+
+		// Invoked when a new operation is created.
+		void on_operation_created(size_t operation_id, size_t group_id)
+		{
+			arms[current_arm].strategy->on_operation_created(operation_id, group_id);
+		}
+
+		// Invoked when an operation becomes enabled.
+		void on_operation_enabled(size_t operation_id)
+		{
+			arms[current_arm].strategy->on_operation_enabled(operation_id);
+		}
+
+		// Invoked when an operation becomes blocked.
+		void on_operation_blocked(size_t operation_id)
+		{
+			arms[current_arm].strategy->on_operation_blocked(operation_id);
+		}
+
+		// Invoked when an operation completes.
+		void on_operation_completed(size_t operation_id)
+		{
+			arms[current_arm].strategy->on_operation_completed(operation_id);
+		}
+
+		// Invoked when a resource is signaled.
+		void on_resource_signaled(size_t resource_id)
+		{
+			arms[current_arm].strategy->on_resource_signaled(resource_id);
+		}
+
+		// Invoked when a bug is found in the current iteration.
+		void on_bug_found()
+		{
+			is_bug_found = true;
+			arms[current_arm].strategy->on_bug_found();
+		}
+
+		// Returns the index of the strategy that explores the current iteration.
+		size_t iteration_strategy_index()
+		{
+			return current_arm;
+		}
+
+	private:
+		void add_strategy(StrategyType type, size_t bound, uint64_t seed)
+		{
+			// Derive a distinct seed for each strategy, so that strategies of the same type do not
+			// explore the same schedules.
+			uint64_t strategy_seed = seed ^ (0x9E3779B97F4A7C15ULL * (arms.size() + 1));
+
+			auto settings = std::make_unique<Settings>();
+			std::unique_ptr<Strategy> strategy;
+			if (type == StrategyType::PCT)
+			{
+				settings->use_pct_strategy(strategy_seed, bound);
+				strategy = std::make_unique<PCTStrategy>(settings.get());
+			}
+			else if (type == StrategyType::PCTCP)
+			{
+				settings->use_pctcp_strategy(strategy_seed, bound);
+				strategy = std::make_unique<PCTCPStrategy>(settings.get());
+			}
+			else if (type == StrategyType::QLearning)
+			{
+				settings->use_qlearning_strategy(strategy_seed);
+				strategy = std::make_unique<QLearningStrategy>(settings.get());
+			}
+			else
+			{
+				settings->use_random_strategy(strategy_seed, bound);
+				strategy = std::make_unique<RandomStrategy>(settings.get());
+			}
+
+			arms.push_back(Arm{ std::move(settings), std::move(strategy), 0, 0 });
+		}
+
+		// Selects the strategy with the highest upper confidence bound. Strategies that have not
+		// explored any iteration are selected first, in order.
+		size_t select_arm()
+		{
+			size_t best_arm = 0;
+			double best_value = -HUGE_VAL;
+			for (size_t idx = 0; idx < arms.size(); idx++)
+			{
+				const Arm& arm = arms[idx];
+				if (arm.iterations == 0)
+				{
+					return idx;
+				}
+
+				double mean = arm.total_reward / arm.iterations;
+				double value = mean + std::sqrt(2 * std::log((double)total_iterations) / arm.iterations);
+				if (value > best_value)
+				{
+					best_arm = idx;
+					best_value = value;
+				}
+			}
+
+			return best_arm;
+		}
+
+		// Records the context switch from the specified operation to the next one.
+		void cover_edge(size_t operation_id, size_t next_operation_id)
+		{
+			uint64_t key = ((uint64_t)operation_id * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)next_operation_id;
+			if (covered_edges.insert(key).second)
+			{
+				is_new_edge_covered = true;
+			}
+		}
+	};
+}
+
+#endif // COYOTE_PORTFOLIO_STRATEGY_H
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_Q_TABLE_H
+#define COYOTE_Q_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace coyote
+{
+	// Flat open-addressing hash map from (state, operation) pairs to Q-values. Entries live in a
+	// single contiguous array that is probed linearly, so lookups on the scheduling hot path touch
+	// one or two cache lines and never allocate.
+	class QTable
+	{
+	private:
+		struct Entry
+		{
+			uint64_t key;
+			double value;
+		};
+
+		// The reserved key that marks an empty slot.
+		static constexpr uint64_t EMPTY_KEY = 0;
+
+		// The initial number of slots, which must be a power of two.
+		static constexpr size_t INITIAL_CAPACITY = 1 << 16;
+
+		// Slots of the table.
+		std::vector<Entry> entries;
+
+		// Mask used to map a hash to a slot.
+		size_t mask;
+
+		// Number of occupied slots.
+		size_t count;
+
+	public:
+		QTable() noexcept :
+			entries(INITIAL_CAPACITY, Entry{ EMPTY_KEY, 0 }),
+			mask(INITIAL_CAPACITY - 1),
+			count(0)
+		{
+		}
+
+		QTable(QTable&& table) = delete;
+		QTable(QTable const&) = delete;
+
+		QTable& operator=(QTable&& table) = delete;
+		QTable& operator=(QTable const&) = delete;
+
+		// Returns the Q-value of the specified state and operation, or zero if it is not known.
+		double get(uint64_t state, size_t operation_id) const
+		{
+			const uint64_t key = make_key(state, operation_id);
+			for (size_t idx = key & mask; ; idx = (idx + 1) & mask)
+			{
+				const Entry& entry = entries[idx];
+				if (entry.key == key)
+				{
+					return entry.value;
+				}
+				else if (entry.key == EMPTY_KEY)
+				{
+					return 0;
+				}
+			}
+		}
+
+		// Assigns the Q-value of the specified state and operation.
+		void set(uint64_t state, size_t operation_id, double value)
+		{
+			// Keep the load factor under one half so that probe sequences stay short.
+			if ((count + 1) * 2 > entries.size())
+			{
+				grow();
+			}
+
+			insert(make_key(state, operation_id), value);
+		}
+
+		// Returns the number of stored Q-values.
+		size_t size() const
+		{
+			return count;
+		}
+
+		void clear()
+		{
+			entries.assign(INITIAL_CAPACITY, Entry{ EMPTY_KEY, 0 });
+			mask = INITIAL_CAPACITY - 1;
+			count = 0;
+		}
+
+	private:
+		void insert(uint64_t key, double value)
+		{
+			for (size_t idx = key & mask; ; idx = (idx + 1) & mask)
+			{
+				Entry& entry = entries[idx];
+				if (entry.key == key)
+				{
+					entry.value = value;
+					return;
+				}
+				else if (entry.key == EMPTY_KEY)
+				{
+					entry.key = key;
+					entry.value = value;
+					count++;
+					return;
+				}
+			}
+		}
+
+		void grow()
+		{
+			std::vector<Entry> old_entries(entries.size() * 2, Entry{ EMPTY_KEY, 0 });
+			old_entries.swap(entries);
+			mask = entries.size() - 1;
+			count = 0;
+
+			for (const Entry& entry : old_entries)
+			{
+				if (entry.key != EMPTY_KEY)
+				{
+					insert(entry.key, entry.value);
+				}
+			}
+		}
+
+		// Combines the state and operation into a well-mixed key that is never the empty key.
+		static uint64_t make_key(uint64_t state, size_t operation_id)
+		{
+			uint64_t key = state ^ (((uint64_t)operation_id + 1) * 0x9E3779B97F4A7C15ULL);
+			key ^= key >> 33;
+			key *= 0xFF51AFD7ED558CCDULL;
+			key ^= key >> 33;
+			return key == EMPTY_KEY ? 1 : key;
+		}
+	};
+}
+
+#endif // COYOTE_Q_TABLE_H
@@ -0,0 +1,273 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_QLEARNING_STRATEGY_H
+#define COYOTE_QLEARNING_STRATEGY_H
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "q_table.h"
+#include "random.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Strategy that uses Q-learning to prefer scheduling decisions that lead to new program states.
+	// Every scheduling step receives a negative reward, so state-operation pairs that have been taken
+	// often accumulate lower Q-values, and the softmax choice drifts toward less explored decisions.
+	class QLearningStrategy : public Strategy
+	{
+	private:
+		// A scheduling decision taken during the current iteration.
+		struct Step
+		{
+			// Hash of the abstract state in which the decision was taken.
+			uint64_t state;
+
+			// The chosen operation.
+			size_t operation_id;
+
+			// Offset in 'step_operations' of the operations that were enabled in this state.
+			size_t offset;
+
+			// Number of operations that were enabled in this state.
+			size_t size;
+		};
+
+		// The rate at which new rewards override previously learned Q-values.
+		static constexpr double LEARNING_RATE = 0.3;
+
+		// The discount applied to the Q-value of the next state.
+		static constexpr double DISCOUNT_FACTOR = 0.7;
+
+		// The reward given to each scheduling step.
+		static constexpr double STEP_REWARD = -1;
+
+		// The pseudo-random generator.
+		Random generator;
+
+		// The seed with which the strategy was created.
+		const uint64_t initial_seed;
+
+		// The seed used by the current iteration.
+		uint64_t iteration_seed;
+
+		// Number of iterations explored so far, including the current one.
+		size_t iteration_count;
+
+		// The learned Q-values.
+		QTable q_table;
+
+		// The scheduling decisions of the current iteration.
+		std::vector<Step> steps;
+
+		// The enabled operations of each scheduling decision, stored contiguously.
+		std::vector<size_t> step_operations;
+
+		// Scratch buffer of softmax weights, reused across steps.
+		std::vector<double> weights;
+
+	public:
+		QLearningStrategy(Settings* settings) noexcept :
+			generator(settings->random_seed()),
+			initial_seed(settings->random_seed()),
+			iteration_seed(settings->random_seed()),
+			iteration_count(1)
+		{
+		}
+
+		QLearningStrategy(QLearningStrategy&& strategy) = delete;
+		QLearningStrategy(QLearningStrategy const&) = delete;
+
+		QLearningStrategy& operator=(QLearningStrategy&& strategy) = delete;
+		QLearningStrategy& operator=(QLearningStrategy const&) = delete;
+
+		// Returns the next operation.
+		int next_operation(Operations& operations, size_t current)
+		{
+			const uint64_t state = hash_state(operations, current);
+			const size_t offset = step_operations.size();
+			const size_t size = operations.size();
+
+			// Compute the softmax distribution over the Q-values of the enabled operations. The
+			// maximum is subtracted before exponentiation to keep the weights in range.
+			double max_value = -HUGE_VAL;
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				size_t op = operations[idx];
+				step_operations.push_back(op);
+				double value = q_table.get(state, op);
+				weights.push_back(value);
+				if (value > max_value)
+				{
+					max_value = value;
+				}
+			}
+
+			double sum = 0;
+			for (double& weight : weights)
+			{
+				weight = std::exp(weight - max_value);
+				sum += weight;
+			}
+
+			double point = next_double() * sum;
+			size_t choice = size - 1;
+			for (size_t idx = 0; idx < size; idx++)
+			{
+				point -= weights[idx];
+				if (point < 0)
+				{
+					choice = idx;
+					break;
+				}
+			}
+
+			weights.clear();
+
+			size_t next_op = step_operations[offset + choice];
+			steps.push_back(Step{ state, next_op, offset, size });
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::qlearning] choosing operation " << next_op << " in state " << state << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			return (int)next_op;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return (generator.next() & 1) == 0;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
+
+		// Returns the seed used in the current iteration. Note that the choices of an iteration also
+		// depend on the Q-values learned from all previous iterations.
+		uint64_t random_seed()
+		{
+			return iteration_seed;
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t iteration)
+		{
+			iteration_count = iteration;
+
+			learn();
+
+			steps.clear();
+			step_operations.clear();
+
+			iteration_seed += 1;
+			generator.seed(iteration_seed);
+		}
+
+		// Returns the type of this strategy.
+		StrategyType exploration_strategy()
+		{
+			return StrategyType::QLearning;
+		}
+
+		// Returns zero, as this strategy is not bounded.
+		size_t exploration_strategy_bound()
+		{
+			return 0;
+		}
+
+		// Returns the seed with which this strategy was created.
+		uint64_t exploration_strategy_seed()
+		{
+			return initial_seed;
+		}
+
+		// Returns the number of iterations explored so far, including the current one.
+		size_t exploration_strategy_iteration()
+		{
+			return iteration_count;
+		}
+
+		// Returns the number of learned Q-values.
+		size_t learned_values_count()
+		{
+			return q_table.size();
+		}
+
+	private:
+		// Updates the Q-values from the decisions of the last iteration, starting from the last
+		// decision so that rewards propagate backwards through the schedule in a single pass.
+		void learn()
+		{
+			for (size_t idx = steps.size(); idx > 0; idx--)
+			{
+				const Step& step = steps[idx - 1];
+
+				double next_max_value = 0;
+				if (idx < steps.size())
+				{
+					const Step& next_step = steps[idx];
+					next_max_value = -HUGE_VAL;
+					for (size_t i = 0; i < next_step.size; i++)
+					{
+						double value = q_table.get(next_step.state, step_operations[next_step.offset + i]);
+						if (value > next_max_value)
+						{
+							next_max_value = value;
+						}
+					}
+				}
+
+				double value = q_table.get(step.state, step.operation_id);
+				value += LEARNING_RATE * (STEP_REWARD + (DISCOUNT_FACTOR * next_max_value) - value);
+				q_table.set(step.state, step.operation_id, value);
+			}
+		}
+
+		// Returns a hash of the abstract program state, which consists of the current operation, the
+		// enabled operations and the disabled operations. The set hashes are order independent, as
+		// the order of operations in the vector depends on the history of enable and disable calls.
+		uint64_t hash_state(Operations& operations, size_t current)
+		{
+			const size_t enabled_size = operations.size();
+			const size_t disabled_size = operations.size(false);
+
+			uint64_t enabled_hash = 0;
+			for (size_t idx = 0; idx < enabled_size; idx++)
+			{
+				enabled_hash += mix(operations[idx]);
+			}
+
+			uint64_t disabled_hash = 0;
+			for (size_t idx = enabled_size; idx < enabled_size + disabled_size; idx++)
+			{
+				disabled_hash += mix(operations[idx]);
+			}
+
+			uint64_t hash = mix(current);
+			hash = mix(hash ^ enabled_hash);
+			hash = mix(hash ^ (disabled_hash * 31));
+			return hash;
+		}
+
+		// Returns a uniformly distributed value in the [0, 1) range.
+		double next_double()
+		{
+			return (generator.next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		static uint64_t mix(uint64_t value)
+		{
+			value += 0x9E3779B97F4A7C15ULL;
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+			return value ^ (value >> 31);
+		}
+	};
+}
+
+#endif // COYOTE_QLEARNING_STRATEGY_H
@@ -20,11 +20,9 @@ namespace coyote
 		uint64_t y;
 
 	public:
-		Random(uint64_t seed) noexcept :
-			x(seed == 0 ? 5489 : seed),
-			y(seed)
+		Random(uint64_t seed) noexcept
 		{
-			next();
+			this->seed(seed);
 		}
 
 		Random(Random&& strategy) = delete;
@@ -33,11 +31,17 @@ namespace coyote
 		Random& operator=(Random&& strategy) = delete;
 		Random& operator=(Random const&) = delete;
 
+		// Seeds the generator. The seed is expanded into the state with splitmix64, as seeding the state
+		// directly makes the sequences of consecutive seeds, as used across iterations, highly correlated.
 		void seed(const uint64_t seed)
 		{
-			x = seed == 0 ? 5489 : seed;
-			y = seed;
-			next();
+			uint64_t state = seed;
+			x = splitmix(state);
+			y = splitmix(state);
+			if (x == 0 && y == 0)
+			{
+				x = 5489;
+			}
 		}
 
 		// Returns the next random number.
@@ -50,6 +54,14 @@ namespace coyote
 			return r >> (STATE_BITS - RESULT_BITS);
 		}
 	private:
+		static inline uint64_t splitmix(uint64_t& state)
+		{
+			uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
 		static inline uint64_t rotl(const uint64_t x, const uint64_t k)
 		{
 			return (x << k) | (x >> (STATE_BITS - k));
@@ -4,6 +4,7 @@
 #ifndef COYOTE_RANDOM_STRATEGY_H
 #define COYOTE_RANDOM_STRATEGY_H
 
+#include <unordered_set>
 #include "random.h"
 #include "strategy.h"
 #include "../settings.h"
@@ -16,17 +17,32 @@ namespace coyote
 		// The pseudo-random generator.
 		Random generator;
 
+		// The seed with which the strategy was created.
+		const uint64_t initial_seed;
+
 		// The seed used by the current iteration.
 		uint64_t iteration_seed;
 
+		// Number of iterations explored so far, including the current one.
+		size_t iteration_count;
+
 		// The probability of deviating from the current operation if it is enabled.
 		size_t scheduling_deviation_probability;
 
+		// Set of enabled operations, which is maintained through the operation events.
+		std::unordered_set<size_t> enabled_operations;
+
+		// True if the operation events are reported, else false.
+		bool is_tracking_operations;
+
 	public:
 		RandomStrategy(Settings* settings) noexcept :
 			generator(settings->random_seed()),
+			initial_seed(settings->random_seed()),
 			iteration_seed(settings->random_seed()),
-			scheduling_deviation_probability(settings->exploration_strategy_bound())
+			iteration_count(1),
+			scheduling_deviation_probability(settings->exploration_strategy_bound()),
+			is_tracking_operations(false)
 		{
 		}
 
@@ -42,12 +58,19 @@ namespace coyote
 			if (scheduling_deviation_probability < 100)
 			{
 				bool isCurrentEnabled = false;
-				for (size_t idx = 0; idx < operations.size(); idx++)
+				if (is_tracking_operations)
 				{
-					if (operations[idx] == current)
+					isCurrentEnabled = enabled_operations.find(current) != enabled_operations.end();
+				}
+				else
+				{
+					for (size_t idx = 0; idx < operations.size(); idx++)
 					{
-						isCurrentEnabled = true;
-						break;
+						if (operations[idx] == current)
+						{
+							isCurrentEnabled = true;
+							break;
+						}
 					}
 				}
 
@@ -81,8 +104,59 @@ namespace coyote
 		// Prepares the next iteration.
 		void prepare_next_iteration(size_t iteration)
 		{
+			iteration_count = iteration;
+
 			iteration_seed += 1;
 			generator.seed(iteration_seed);
+			enabled_operations.clear();
+		}
+
+		// Returns the type of this strategy.
+		StrategyType exploration_strategy()
+		{
+			return StrategyType::Random;
+		}
+
+		// Returns the probability of deviating from the current operation.
+		size_t exploration_strategy_bound()
+		{
+			return scheduling_deviation_probability;
+		}
+
+		// Returns the seed with which this strategy was created.
+		uint64_t exploration_strategy_seed()
+		{
+			return initial_seed;
+		}
+
+		// Returns the number of iterations explored so far, including the current one.
+		size_t exploration_strategy_iteration()
+		{
+			return iteration_count;
+		}
+
+		// Starts tracking the enabled operations.
+		void on_operation_created(size_t /* operation_id */, size_t /* group_id */)
+		{
+			is_tracking_operations = true;
+		}
+
+		// Adds the operation to the set of enabled operations.
+		void on_operation_enabled(size_t operation_id)
+		{
+			enabled_operations.insert(operation_id);
+		}
+
+		// Removes the operation from the set of enabled operations.
+		void on_operation_blocked(size_t operation_id)
+		{
+			enabled_operations.erase(operation_id);
+		}
+
+		// Removes the operation from the set of enabled operations.
+		void on_operation_completed(size_t operation_id)
+		{
+			enabled_operations.erase(operation_id);
 		}
 	};
 }
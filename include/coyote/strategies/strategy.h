@@ -4,6 +4,7 @@
 #ifndef COYOTE_STRATEGY_H
 #define COYOTE_STRATEGY_H
 
+#include "strategy_type.h"
 #include "../operations/operations.h"
 
 namespace coyote
@@ -26,6 +27,39 @@ namespace coyote
 		// Prepares the next iteration.
 		virtual void prepare_next_iteration(size_t iteration) = 0;
 
+		// Returns the type of the strategy that explores the current iteration.
+		virtual StrategyType exploration_strategy() = 0;
+
+		// Returns the bound of the strategy that explores the current iteration.
+		virtual size_t exploration_strategy_bound() = 0;
+
+		// Returns the seed with which the strategy that explores the current iteration was created.
+		virtual uint64_t exploration_strategy_seed() = 0;
+
+		// Returns the number of iterations, including the current one, that have been explored by the
+		// strategy that explores the current iteration.
+		virtual size_t exploration_strategy_iteration() = 0;
+
+		// Invoked when a new operation is created, with the id of its group, or with
+		// 'Operation::ungrouped_id' if it was created without an explicit group.
+		virtual void on_operation_created(size_t /* operation_id */, size_t /* group_id */) {}
+
+		// Invoked when an operation becomes enabled, either because it started or because the
+		// operations or resources that it was waiting for completed or were signaled.
+		virtual void on_operation_enabled(size_t /* operation_id */) {}
+
+		// Invoked when an operation becomes blocked waiting for operations or resources.
+		virtual void on_operation_blocked(size_t /* operation_id */) {}
+
+		// Invoked when an operation completes.
+		virtual void on_operation_completed(size_t /* operation_id */) {}
+
+		// Invoked when a resource is signaled, after the operations that it enabled were reported.
+		virtual void on_resource_signaled(size_t /* resource_id */) {}
+
+		// Invoked when a bug is found in the current iteration.
+		virtual void on_bug_found() {}
+
 		virtual ~Strategy() = default;
 	};
 }
@@ -10,7 +10,10 @@ namespace coyote
     {
         None = 0,
         Random,
-        PCT
+        PCT,
+        PCTCP,
+        QLearning,
+        Portfolio
     };
 }
 
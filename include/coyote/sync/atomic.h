@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_ATOMIC_H
+#define COYOTE_ATOMIC_H
+
+#include <atomic>
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// An atomic value with the interface of 'std::atomic' that inserts a scheduling point before its
+	// accesses while the scheduler controls it. Which accesses are scheduling points is configured by
+	// 'Settings::use_atomic_density'. If scheduling is disabled, each access reduces to a single branch
+	// before the access of the underlying 'std::atomic', and to no branch if 'COYOTE_DISABLE' is defined.
+	// The arithmetic and bitwise operations are only available for the types that 'std::atomic' supports
+	// them for.
+	template <typename T>
+	class atomic
+	{
+	private:
+		// The scheduler that controls the atomic.
+		Scheduler* scheduler;
+
+		// The underlying atomic value.
+		std::atomic<T> value;
+
+	public:
+		static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+		atomic(Scheduler* s) noexcept :
+			scheduler(s),
+			value()
+		{
+		}
+
+		atomic(Scheduler* s, T desired) noexcept :
+			scheduler(s),
+			value(desired)
+		{
+		}
+
+		atomic(atomic&& a) = delete;
+		atomic(atomic const&) = delete;
+
+		atomic& operator=(atomic&& a) = delete;
+		atomic& operator=(atomic const&) = delete;
+
+		T operator=(T desired) noexcept
+		{
+			store(desired);
+			return desired;
+		}
+
+		operator T() const noexcept
+		{
+			return load();
+		}
+
+		bool is_lock_free() const noexcept
+		{
+			return value.is_lock_free();
+		}
+
+		void store(T desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(false, order);
+			value.store(desired, order);
+		}
+
+		T load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+		{
+			schedule_next(false, order);
+			return value.load(order);
+		}
+
+		T exchange(T desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.exchange(desired, order);
+		}
+
+		bool compare_exchange_weak(T& expected, T desired, std::memory_order success,
+			std::memory_order failure) noexcept
+		{
+			schedule_next(true, success);
+			return value.compare_exchange_weak(expected, desired, success, failure);
+		}
+
+		bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.compare_exchange_weak(expected, desired, order);
+		}
+
+		bool compare_exchange_strong(T& expected, T desired, std::memory_order success,
+			std::memory_order failure) noexcept
+		{
+			schedule_next(true, success);
+			return value.compare_exchange_strong(expected, desired, success, failure);
+		}
+
+		bool compare_exchange_strong(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.compare_exchange_strong(expected, desired, order);
+		}
+
+		template <typename U>
+		T fetch_add(U arg, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.fetch_add(arg, order);
+		}
+
+		template <typename U>
+		T fetch_sub(U arg, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.fetch_sub(arg, order);
+		}
+
+		T fetch_and(T arg, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.fetch_and(arg, order);
+		}
+
+		T fetch_or(T arg, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.fetch_or(arg, order);
+		}
+
+		T fetch_xor(T arg, std::memory_order order = std::memory_order_seq_cst) noexcept
+		{
+			schedule_next(true, order);
+			return value.fetch_xor(arg, order);
+		}
+
+		T operator++() noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return ++value;
+		}
+
+		T operator++(int) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value++;
+		}
+
+		T operator--() noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return --value;
+		}
+
+		T operator--(int) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value--;
+		}
+
+		template <typename U>
+		T operator+=(U arg) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value += arg;
+		}
+
+		template <typename U>
+		T operator-=(U arg) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value -= arg;
+		}
+
+		T operator&=(T arg) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value &= arg;
+		}
+
+		T operator|=(T arg) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value |= arg;
+		}
+
+		T operator^=(T arg) noexcept
+		{
+			schedule_next(true, std::memory_order_seq_cst);
+			return value ^= arg;
+		}
+
+	private:
+		// Schedules the next operation before the access, if it is a scheduling point.
+		void schedule_next(bool is_read_modify_write, std::memory_order order) const noexcept
+		{
+			if (scheduler->is_enabled() && scheduler->is_atomic_scheduling_point(is_read_modify_write, order))
+			{
+				scheduler->schedule_next();
+			}
+		}
+	};
+}
+
+#endif // COYOTE_ATOMIC_H
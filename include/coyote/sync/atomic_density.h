@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_ATOMIC_DENSITY_H
+#define COYOTE_ATOMIC_DENSITY_H
+
+namespace coyote
+{
+    // Which accesses of controlled atomics are scheduling points.
+    enum class AtomicDensity
+    {
+        // Every load, store and read-modify-write.
+        EveryAccess = 0,
+        // Only read-modify-writes and sequentially consistent loads and stores.
+        Synchronizing,
+        // Every access with a configured probability.
+        Sampled
+    };
+}
+
+#endif // COYOTE_ATOMIC_DENSITY_H
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_BARRIER_H
+#define COYOTE_BARRIER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// The default completion function of a barrier, which does nothing.
+	struct barrier_completion
+	{
+		void operator()() noexcept
+		{
+		}
+	};
+
+	// A reusable barrier with the interface of the C++20 'std::barrier' that is controlled by the
+	// scheduler. If scheduling is disabled, it blocks on a 'std::mutex' and 'std::condition_variable',
+	// as the library is built against C++17. The completion function runs on the operation that
+	// arrives last in each phase, before the waiting operations are released.
+	template <class CompletionFunction = barrier_completion>
+	class barrier
+	{
+	public:
+		// Identifies the phase in which an operation arrived at the barrier.
+		class arrival_token
+		{
+		private:
+			uint64_t phase;
+
+			arrival_token(uint64_t p) noexcept :
+				phase(p)
+			{
+			}
+
+			friend class barrier;
+		};
+
+	private:
+		ControlledResource resource;
+
+		// The function that runs when a phase completes.
+		CompletionFunction completion;
+
+		// The count of arrivals that are expected in each phase.
+		std::ptrdiff_t expected_count;
+
+		// The count of arrivals that are still expected in the current phase.
+		std::ptrdiff_t pending_count;
+
+		// The current phase.
+		uint64_t phase;
+
+		// The native mutex and condition variable, which are used if scheduling is disabled.
+		std::mutex native_mutex;
+		std::condition_variable native_cv;
+
+	public:
+		barrier(Scheduler* scheduler, std::ptrdiff_t expected, CompletionFunction f = CompletionFunction()) :
+			resource(scheduler),
+			completion(std::move(f)),
+			expected_count(expected),
+			pending_count(expected),
+			phase(0)
+		{
+		}
+
+		barrier(barrier&& b) = delete;
+		barrier(barrier const&) = delete;
+
+		barrier& operator=(barrier&& b) = delete;
+		barrier& operator=(barrier const&) = delete;
+
+		// Returns the maximum number of arrivals that a barrier supports.
+		static constexpr std::ptrdiff_t max() noexcept
+		{
+			return PTRDIFF_MAX;
+		}
+
+		// Arrives at the barrier and decrements the expected count of the current phase by the
+		// specified value, without waiting.
+		arrival_token arrive(std::ptrdiff_t update = 1)
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				return arrive_inner(update);
+			}
+
+			resource.schedule_next();
+			return arrive_inner(update);
+		}
+
+		// Waits until the phase of the specified token completes.
+		void wait(arrival_token&& token)
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				native_cv.wait(lock, [this, &token]() { return phase != token.phase; });
+				return;
+			}
+
+			while (phase == token.phase && resource.wait())
+			{
+			}
+		}
+
+		// Arrives at the barrier and waits until the current phase completes.
+		void arrive_and_wait()
+		{
+			wait(arrive());
+		}
+
+		// Arrives at the barrier and decrements the expected count of the current phase and of all
+		// subsequent phases by one.
+		void arrive_and_drop()
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				expected_count--;
+				arrive_inner(1);
+				return;
+			}
+
+			resource.schedule_next();
+			expected_count--;
+			arrive_inner(1);
+		}
+
+	private:
+		arrival_token arrive_inner(std::ptrdiff_t update)
+		{
+			arrival_token token(phase);
+			pending_count -= update;
+			if (pending_count == 0)
+			{
+				completion();
+				pending_count = expected_count;
+				phase++;
+				if (resource.is_controlled())
+				{
+					resource.signal();
+				}
+				else
+				{
+					native_cv.notify_all();
+				}
+			}
+
+			return token;
+		}
+	};
+}
+
+#endif // COYOTE_BARRIER_H
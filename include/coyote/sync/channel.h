@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CHANNEL_H
+#define COYOTE_CHANNEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A multi-producer multi-consumer channel of messages that is controlled by the scheduler. A channel
+	// is unbounded, or bounded by a capacity of at least one message, in which case senders wait while it
+	// is full. Sending and receiving are scheduling points, and each sent message enables at most one
+	// waiting receiver, so receivers are only enabled when a message is available. The exploration
+	// strategy decides which waiting receiver or sender wakes up, and, if the channel reorders deliveries,
+	// which pending message is received next. If scheduling is disabled, the channel uses a 'std::mutex'
+	// and 'std::condition_variable' and delivers messages in order.
+	template <typename T>
+	class channel
+	{
+	public:
+		// The capacity of an unbounded channel.
+		static constexpr size_t unbounded = SIZE_MAX;
+
+	private:
+		// The resource that receivers wait while the channel is empty.
+		ControlledResource receive_resource;
+
+		// The resource that senders wait while the channel is full.
+		ControlledResource send_resource;
+
+		// The ids of the operations that are waiting to receive or send while the channel is controlled.
+		std::vector<size_t> waiting_receiver_ids;
+		std::vector<size_t> waiting_sender_ids;
+
+		// The pending messages.
+		std::deque<T> messages;
+
+		// The maximum number of pending messages.
+		const size_t max_size;
+
+		// True if the strategy chooses which pending message is received next, else false.
+		const bool is_reordering;
+
+		// True if the channel is closed, else false.
+		bool is_closed;
+
+		// The native mutex and condition variables, which are used if scheduling is disabled.
+		std::mutex native_mutex;
+		std::condition_variable native_receive_cv;
+		std::condition_variable native_send_cv;
+
+	public:
+		channel(Scheduler* scheduler, size_t capacity = unbounded, bool reorder_deliveries = false) noexcept :
+			receive_resource(scheduler),
+			send_resource(scheduler),
+			max_size(std::max<size_t>(capacity, 1)),
+			is_reordering(reorder_deliveries),
+			is_closed(false)
+		{
+		}
+
+		channel(channel&& c) = delete;
+		channel(channel const&) = delete;
+
+		channel& operator=(channel&& c) = delete;
+		channel& operator=(channel const&) = delete;
+
+		// Returns the maximum number of pending messages.
+		size_t capacity() const noexcept
+		{
+			return max_size;
+		}
+
+		// Sends the specified message, waiting while the channel is full. Returns false if the channel
+		// is closed, else true.
+		bool send(T message)
+		{
+			if (!receive_resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				native_send_cv.wait(lock, [this]() { return is_closed || messages.size() < max_size; });
+				return push_native(std::move(message));
+			}
+
+			send_resource.schedule_next();
+			while (!is_closed && messages.size() >= max_size && wait(send_resource, waiting_sender_ids))
+			{
+			}
+
+			return push_controlled(std::move(message));
+		}
+
+		// Sends the specified message without waiting. Returns true if it was sent, else false.
+		bool try_send(T message)
+		{
+			if (!receive_resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				return push_native(std::move(message));
+			}
+
+			send_resource.schedule_next();
+			return push_controlled(std::move(message));
+		}
+
+		// Receives a message, waiting while the channel is empty. Returns false if the channel is closed
+		// and empty, else true.
+		bool receive(T& message)
+		{
+			if (!receive_resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				native_receive_cv.wait(lock, [this]() { return is_closed || !messages.empty(); });
+				return pop_native(message);
+			}
+
+			receive_resource.schedule_next();
+			while (!is_closed && messages.empty() && wait(receive_resource, waiting_receiver_ids))
+			{
+			}
+
+			return pop_controlled(message);
+		}
+
+		// Receives a message without waiting. Returns true if a message was received, else false.
+		bool try_receive(T& message)
+		{
+			if (!receive_resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				return pop_native(message);
+			}
+
+			receive_resource.schedule_next();
+			return pop_controlled(message);
+		}
+
+		// Closes the channel. Pending messages can still be received, but no more can be sent, and all
+		// waiting receivers and senders wake up.
+		void close()
+		{
+			if (!receive_resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				is_closed = true;
+				native_receive_cv.notify_all();
+				native_send_cv.notify_all();
+				return;
+			}
+
+			send_resource.schedule_next();
+			is_closed = true;
+			notify_all(receive_resource, waiting_receiver_ids);
+			notify_all(send_resource, waiting_sender_ids);
+		}
+
+	private:
+		bool push_native(T&& message)
+		{
+			if (is_closed || messages.size() >= max_size)
+			{
+				return false;
+			}
+
+			messages.push_back(std::move(message));
+			native_receive_cv.notify_one();
+			return true;
+		}
+
+		bool pop_native(T& message)
+		{
+			if (messages.empty())
+			{
+				return false;
+			}
+
+			message = std::move(messages.front());
+			messages.pop_front();
+			native_send_cv.notify_one();
+			return true;
+		}
+
+		bool push_controlled(T&& message)
+		{
+			if (is_closed || messages.size() >= max_size)
+			{
+				return false;
+			}
+
+			messages.push_back(std::move(message));
+			notify_one(receive_resource, waiting_receiver_ids);
+			return true;
+		}
+
+		bool pop_controlled(T& message)
+		{
+			if (messages.empty())
+			{
+				return false;
+			}
+
+			size_t index = 0;
+			if (is_reordering && messages.size() > 1)
+			{
+				index = (size_t)receive_resource.controlling_scheduler()->next_integer((int)messages.size());
+			}
+
+			message = std::move(messages[index]);
+			messages.erase(messages.begin() + index);
+			notify_one(send_resource, waiting_sender_ids);
+			return true;
+		}
+
+		// Waits the specified resource to be signaled. Returns false if the scheduler reported an error,
+		// else true.
+		bool wait(ControlledResource& resource, std::vector<size_t>& waiting_ids)
+		{
+			size_t operation_id = resource.controlling_scheduler()->scheduled_operation_id();
+			waiting_ids.push_back(operation_id);
+			bool is_signaled = resource.wait();
+			if (!is_signaled)
+			{
+				// The wait failed, so stop waiting to be signaled.
+				auto it = std::find(waiting_ids.begin(), waiting_ids.end(), operation_id);
+				if (it != waiting_ids.end())
+				{
+					waiting_ids.erase(it);
+				}
+			}
+
+			return is_signaled;
+		}
+
+		// Wakes up one of the operations that are waiting the specified resource, if there is one.
+		void notify_one(ControlledResource& resource, std::vector<size_t>& waiting_ids)
+		{
+			if (!waiting_ids.empty())
+			{
+				int index = resource.controlling_scheduler()->next_integer((int)waiting_ids.size());
+				size_t operation_id = waiting_ids[index];
+				waiting_ids.erase(waiting_ids.begin() + index);
+				resource.signal(operation_id);
+			}
+		}
+
+		// Wakes up all operations that are waiting the specified resource.
+		void notify_all(ControlledResource& resource, std::vector<size_t>& waiting_ids)
+		{
+			if (!waiting_ids.empty())
+			{
+				waiting_ids.clear();
+				resource.signal();
+			}
+		}
+	};
+}
+
+#endif // COYOTE_CHANNEL_H
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CONDITION_VARIABLE_H
+#define COYOTE_CONDITION_VARIABLE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <vector>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A condition variable with the interface of 'std::condition_variable_any' that is controlled by
+	// the scheduler, or that uses a 'std::condition_variable_any' if scheduling is disabled. It can be
+	// used with any lock, such as 'std::unique_lock<coyote::mutex>'. The exploration strategy decides
+	// which waiting operation 'notify_one' wakes up.
+	class condition_variable
+	{
+	private:
+		ControlledResource resource;
+
+		// The ids of the operations that are waiting to be notified while the condition variable is
+		// controlled.
+		std::vector<size_t> waiting_operation_ids;
+
+		// The native condition variable, which is used if scheduling is disabled.
+		std::condition_variable_any native_cv;
+
+	public:
+		condition_variable(Scheduler* scheduler) noexcept :
+			resource(scheduler)
+		{
+		}
+
+		condition_variable(condition_variable&& cv) = delete;
+		condition_variable(condition_variable const&) = delete;
+
+		condition_variable& operator=(condition_variable&& cv) = delete;
+		condition_variable& operator=(condition_variable const&) = delete;
+
+		// Wakes up one of the waiting operations, if there is one.
+		void notify_one() noexcept
+		{
+			if (!resource.is_controlled())
+			{
+				native_cv.notify_one();
+				return;
+			}
+
+			if (!waiting_operation_ids.empty())
+			{
+				int index = resource.controlling_scheduler()->next_integer((int)waiting_operation_ids.size());
+				size_t operation_id = waiting_operation_ids[index];
+				waiting_operation_ids.erase(waiting_operation_ids.begin() + index);
+				resource.signal(operation_id);
+			}
+		}
+
+		// Wakes up all waiting operations.
+		void notify_all() noexcept
+		{
+			if (!resource.is_controlled())
+			{
+				native_cv.notify_all();
+				return;
+			}
+
+			if (!waiting_operation_ids.empty())
+			{
+				waiting_operation_ids.clear();
+				resource.signal();
+			}
+		}
+
+		// Releases the lock and waits until notified, and then reacquires the lock.
+		template <class Lock>
+		void wait(Lock& lock)
+		{
+			if (!resource.is_controlled())
+			{
+				native_cv.wait(lock);
+				return;
+			}
+
+			wait_controlled(lock);
+		}
+
+		// Waits until notified and the specified predicate is satisfied.
+		template <class Lock, class Predicate>
+		void wait(Lock& lock, Predicate predicate)
+		{
+			if (!resource.is_controlled())
+			{
+				native_cv.wait(lock, predicate);
+				return;
+			}
+
+			// Stop waiting if the scheduler reported an error, as the predicate might never be satisfied.
+			while (!predicate() && wait_controlled(lock))
+			{
+			}
+		}
+
+		// Releases the lock and waits until notified or until the specified duration elapses, and then
+		// reacquires the lock. While controlled, the duration elapses in the virtual time of the scheduler.
+		template <class Lock, class Rep, class Period>
+		std::cv_status wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& duration)
+		{
+			if (!resource.is_controlled())
+			{
+				return native_cv.wait_for(lock, duration);
+			}
+
+			bool is_notified = false;
+			wait_for_controlled(lock, std::chrono::duration_cast<std::chrono::nanoseconds>(duration), is_notified);
+			return is_notified ? std::cv_status::no_timeout : std::cv_status::timeout;
+		}
+
+		// Waits until notified and the specified predicate is satisfied, or until the specified duration
+		// elapses. Returns the value of the predicate.
+		template <class Lock, class Rep, class Period, class Predicate>
+		bool wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& duration, Predicate predicate)
+		{
+			if (!resource.is_controlled())
+			{
+				return native_cv.wait_for(lock, duration, predicate);
+			}
+
+			Scheduler* scheduler = resource.controlling_scheduler();
+			const std::chrono::nanoseconds deadline = scheduler->virtual_time() +
+				std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+			while (!predicate())
+			{
+				std::chrono::nanoseconds remaining = deadline - scheduler->virtual_time();
+				bool is_notified = false;
+				if (remaining.count() <= 0 || !wait_for_controlled(lock, remaining, is_notified) || !is_notified)
+				{
+					return predicate();
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		// Releases the lock and waits until notified or until the specified timeout elapses, and then
+		// reacquires the lock. Returns false if the scheduler reported an error, else true.
+		template <class Lock>
+		bool wait_for_controlled(Lock& lock, std::chrono::nanoseconds timeout, bool& is_notified)
+		{
+			size_t operation_id = resource.controlling_scheduler()->scheduled_operation_id();
+			waiting_operation_ids.push_back(operation_id);
+			lock.unlock();
+
+			bool is_successful = resource.wait_for(timeout, is_notified);
+			if (!is_notified)
+			{
+				// The wait timed out or failed, so stop waiting to be notified.
+				auto it = std::find(waiting_operation_ids.begin(), waiting_operation_ids.end(), operation_id);
+				if (it != waiting_operation_ids.end())
+				{
+					waiting_operation_ids.erase(it);
+				}
+			}
+
+			lock.lock();
+			return is_successful;
+		}
+
+		// Releases the lock and waits until notified, and then reacquires the lock. Returns false if
+		// the scheduler reported an error, else true.
+		template <class Lock>
+		bool wait_controlled(Lock& lock)
+		{
+			size_t operation_id = resource.controlling_scheduler()->scheduled_operation_id();
+			waiting_operation_ids.push_back(operation_id);
+			lock.unlock();
+
+			bool is_notified = resource.wait();
+			if (!is_notified)
+			{
+				// The wait failed, so stop waiting to be notified.
+				auto it = std::find(waiting_operation_ids.begin(), waiting_operation_ids.end(), operation_id);
+				if (it != waiting_operation_ids.end())
+				{
+					waiting_operation_ids.erase(it);
+				}
+			}
+
+			lock.lock();
+			return is_notified;
+		}
+	};
+}
+
+#endif // COYOTE_CONDITION_VARIABLE_H
@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CONTROLLED_RESOURCE_H
+#define COYOTE_CONTROLLED_RESOURCE_H
+
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// A scheduler resource that is owned by a controlled synchronization primitive. The state of a
+	// primitive does not need to be synchronized while the scheduler controls it, as only the scheduled
+	// operation executes. Waiting and signaling only go through the scheduler when an operation must
+	// block or be unblocked, so an uncontended primitive costs a single scheduling point.
+	//
+	// The scheduler deletes all resources when the client detaches, so the resource is created again,
+	// with its initial count of permits, in each testing iteration that uses the primitive.
+	class ControlledResource
+	{
+	private:
+		// The scheduler that controls the resource.
+		Scheduler* scheduler;
+
+		// The unique id of the resource.
+		size_t resource_id;
+
+		// The count of operations that are waiting for the resource to be signaled.
+		size_t waiting_count;
+
+		// The testing iteration in which the resource was created, or zero if it was not created.
+		size_t created_iteration;
+
+		// The count of permits that the resource is created with.
+		const size_t initial_permits;
+
+		// True if the resource is a lock that is owned by the operation that acquired it, else false.
+		const bool is_lock;
+
+	public:
+		ControlledResource(Scheduler* s, size_t permits = 0) noexcept :
+			ControlledResource(s, permits, false)
+		{
+		}
+
+		// Creates a resource that is a lock if 'is_lock_resource' is true, in which case it has a single
+		// permit, and the scheduler can detect the operations that deadlock while waiting for it.
+		ControlledResource(Scheduler* s, size_t permits, bool is_lock_resource) noexcept :
+			scheduler(s),
+			resource_id(0),
+			waiting_count(0),
+			created_iteration(0),
+			initial_permits(is_lock_resource ? 1 : permits),
+			is_lock(is_lock_resource)
+		{
+			if (scheduler->is_enabled())
+			{
+				create_resource();
+			}
+		}
+
+		~ControlledResource()
+		{
+			if (scheduler->is_enabled() && is_resource_created())
+			{
+				scheduler->delete_resource(resource_id);
+			}
+		}
+
+		ControlledResource(ControlledResource&& resource) = delete;
+		ControlledResource(ControlledResource const&) = delete;
+
+		ControlledResource& operator=(ControlledResource&& resource) = delete;
+		ControlledResource& operator=(ControlledResource const&) = delete;
+
+		// Returns true if the scheduler controls the resource, else false.
+		bool is_controlled() const noexcept
+		{
+			return scheduler->is_enabled();
+		}
+
+		// Returns the scheduler that controls the resource.
+		Scheduler* controlling_scheduler() const noexcept
+		{
+			return scheduler;
+		}
+
+		// Schedules the next operation before the current operation accesses the primitive.
+		void schedule_next() noexcept
+		{
+			scheduler->schedule_next();
+		}
+
+		// Waits the resource to be signaled. Returns false if the scheduler has reported an error in the
+		// current testing iteration, such as a deadlock, in which case the caller must stop waiting.
+		bool wait() noexcept
+		{
+			if (!is_resource_created() && !create_resource())
+			{
+				return false;
+			}
+
+			waiting_count++;
+			bool is_signaled = scheduler->wait_resource(resource_id) == ErrorCode::Success;
+			waiting_count--;
+			return is_signaled;
+		}
+
+		// Waits the resource to be signaled, or until the specified timeout elapses in virtual time, and
+		// sets 'is_signaled' to true if the resource was signaled, else false. Returns false if the
+		// scheduler has reported an error in the current testing iteration.
+		bool wait_for(std::chrono::nanoseconds timeout, bool& is_signaled) noexcept
+		{
+			is_signaled = false;
+			if (!is_resource_created() && !create_resource())
+			{
+				return false;
+			}
+
+			waiting_count++;
+			bool is_successful = scheduler->wait_resource_for(resource_id, timeout, is_signaled) == ErrorCode::Success;
+			waiting_count--;
+			return is_successful;
+		}
+
+		// Signals all waiting operations, if there are any.
+		void signal() noexcept
+		{
+			if (waiting_count > 0 && is_resource_created())
+			{
+				scheduler->signal_resource(resource_id);
+			}
+		}
+
+		// Signals the waiting operation with the specified id.
+		void signal(size_t operation_id) noexcept
+		{
+			if (is_resource_created())
+			{
+				scheduler->signal_resource(resource_id, operation_id);
+			}
+		}
+
+		// Acquires a permit, waiting until one is released. Returns false if the scheduler has reported
+		// an error in the current testing iteration.
+		bool acquire() noexcept
+		{
+			if (!is_resource_created() && !create_resource())
+			{
+				return false;
+			}
+
+			return scheduler->acquire_resource(resource_id) == ErrorCode::Success;
+		}
+
+		// Acquires a permit without waiting. Returns true if a permit was acquired, else false.
+		bool try_acquire() noexcept
+		{
+			bool is_acquired = false;
+			if (is_resource_created() || create_resource())
+			{
+				scheduler->try_acquire_resource(resource_id, is_acquired);
+			}
+
+			return is_acquired;
+		}
+
+		// Acquires a permit, waiting until one is released or until the specified timeout elapses in
+		// virtual time, and sets 'is_acquired' to true if a permit was acquired, else false. Returns
+		// false if the scheduler has reported an error in the current testing iteration.
+		bool try_acquire_for(std::chrono::nanoseconds timeout, bool& is_acquired) noexcept
+		{
+			is_acquired = false;
+			if (!is_resource_created() && !create_resource())
+			{
+				return false;
+			}
+
+			return scheduler->acquire_resource_for(resource_id, timeout, is_acquired) == ErrorCode::Success;
+		}
+
+		// Releases a permit, which is handed over to one of the operations waiting to acquire it.
+		void release() noexcept
+		{
+			if (is_resource_created())
+			{
+				scheduler->release_resource(resource_id);
+			}
+		}
+
+	private:
+		// Returns true if the resource exists in the current testing iteration, else false.
+		bool is_resource_created() noexcept
+		{
+			return created_iteration != 0 && created_iteration == scheduler->testing_iteration() &&
+				scheduler->is_client_attached();
+		}
+
+		// Creates the resource in the current testing iteration, if a client is attached. Returns true
+		// if the resource was created, else false.
+		bool create_resource() noexcept
+		{
+			if (!scheduler->is_client_attached())
+			{
+				return false;
+			}
+
+			ErrorCode error_code = is_lock ? scheduler->create_unique_lock(resource_id) :
+				scheduler->create_unique_resource(resource_id, initial_permits);
+			if (error_code != ErrorCode::Success)
+			{
+				return false;
+			}
+
+			created_iteration = scheduler->testing_iteration();
+			waiting_count = 0;
+			return true;
+		}
+	};
+}
+
+#endif // COYOTE_CONTROLLED_RESOURCE_H
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_LATCH_H
+#define COYOTE_LATCH_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A single-use barrier with the interface of the C++20 'std::latch' that is controlled by the
+	// scheduler. If scheduling is disabled, it blocks on a 'std::mutex' and 'std::condition_variable',
+	// as the library is built against C++17.
+	class latch
+	{
+	private:
+		mutable ControlledResource resource;
+
+		// The count of arrivals that are expected before the latch opens.
+		std::ptrdiff_t counter;
+
+		// The native mutex and condition variable, which are used if scheduling is disabled.
+		mutable std::mutex native_mutex;
+		mutable std::condition_variable native_cv;
+
+	public:
+		latch(Scheduler* scheduler, std::ptrdiff_t expected) noexcept :
+			resource(scheduler),
+			counter(expected)
+		{
+		}
+
+		latch(latch&& l) = delete;
+		latch(latch const&) = delete;
+
+		latch& operator=(latch&& l) = delete;
+		latch& operator=(latch const&) = delete;
+
+		// Decrements the counter by the specified value without waiting.
+		void count_down(std::ptrdiff_t update = 1)
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				counter -= update;
+				if (counter == 0)
+				{
+					native_cv.notify_all();
+				}
+
+				return;
+			}
+
+			counter -= update;
+			if (counter == 0)
+			{
+				resource.signal();
+			}
+		}
+
+		// Returns true if the counter has reached zero, else false.
+		bool try_wait() const noexcept
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				return counter == 0;
+			}
+
+			resource.schedule_next();
+			return counter == 0;
+		}
+
+		// Waits until the counter reaches zero.
+		void wait() const
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				native_cv.wait(lock, [this]() { return counter == 0; });
+				return;
+			}
+
+			resource.schedule_next();
+			while (counter > 0 && resource.wait())
+			{
+			}
+		}
+
+		// Decrements the counter by the specified value, and waits until it reaches zero.
+		void arrive_and_wait(std::ptrdiff_t update = 1)
+		{
+			count_down(update);
+			wait();
+		}
+	};
+}
+
+#endif // COYOTE_LATCH_H
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_MUTEX_H
+#define COYOTE_MUTEX_H
+
+#include <mutex>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A mutex with the interface of 'std::mutex' that is controlled by the scheduler, or that uses a
+	// 'std::mutex' if scheduling is disabled. While controlled, the mutex is a lock, which is a resource
+	// with a single permit that is owned by the operation holding it. Acquiring it is a scheduling point,
+	// and releasing it hands it over to one waiting operation chosen by the exploration strategy, so the
+	// other waiting operations stay blocked. Operations that wait for each other's mutexes are reported
+	// as a deadlock as soon as the cycle closes.
+	class mutex
+	{
+	private:
+		ControlledResource resource;
+
+		// The native mutex, which is used if scheduling is disabled.
+		std::mutex native_mutex;
+
+	public:
+		mutex(Scheduler* scheduler) noexcept :
+			resource(scheduler, 1, true)
+		{
+		}
+
+		mutex(mutex&& m) = delete;
+		mutex(mutex const&) = delete;
+
+		mutex& operator=(mutex&& m) = delete;
+		mutex& operator=(mutex const&) = delete;
+
+		// Acquires the mutex, waiting until it is available.
+		void lock()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.lock();
+				return;
+			}
+
+			resource.acquire();
+		}
+
+		// Tries to acquire the mutex without waiting. Returns true if it was acquired, else false.
+		bool try_lock()
+		{
+			if (!resource.is_controlled())
+			{
+				return native_mutex.try_lock();
+			}
+
+			return resource.try_acquire();
+		}
+
+		// Releases the mutex.
+		void unlock()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.unlock();
+				return;
+			}
+
+			resource.release();
+		}
+	};
+}
+
+#endif // COYOTE_MUTEX_H
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SEMAPHORE_H
+#define COYOTE_SEMAPHORE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A semaphore with the interface of the C++20 'std::counting_semaphore' that is controlled by the
+	// scheduler. If scheduling is disabled, it blocks on a 'std::mutex' and 'std::condition_variable',
+	// as the library is built against C++17. While controlled, the permits are counted by the scheduler,
+	// and the exploration strategy decides which waiting operation receives a released permit.
+	template <std::ptrdiff_t LeastMaxValue = PTRDIFF_MAX>
+	class counting_semaphore
+	{
+	private:
+		ControlledResource resource;
+
+		// The count of available permits if scheduling is disabled.
+		std::ptrdiff_t counter;
+
+		// The native mutex and condition variable, which are used if scheduling is disabled.
+		std::mutex native_mutex;
+		std::condition_variable native_cv;
+
+	public:
+		counting_semaphore(Scheduler* scheduler, std::ptrdiff_t desired) noexcept :
+			resource(scheduler, (size_t)desired),
+			counter(desired)
+		{
+		}
+
+		counting_semaphore(counting_semaphore&& semaphore) = delete;
+		counting_semaphore(counting_semaphore const&) = delete;
+
+		counting_semaphore& operator=(counting_semaphore&& semaphore) = delete;
+		counting_semaphore& operator=(counting_semaphore const&) = delete;
+
+		// Returns the maximum value of the internal counter.
+		static constexpr std::ptrdiff_t max() noexcept
+		{
+			return LeastMaxValue;
+		}
+
+		// Releases the specified number of permits.
+		void release(std::ptrdiff_t update = 1)
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				counter += update;
+				native_cv.notify_all();
+				return;
+			}
+
+			for (std::ptrdiff_t i = 0; i < update; i++)
+			{
+				resource.release();
+			}
+		}
+
+		// Acquires a permit, waiting until one is available.
+		void acquire()
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				native_cv.wait(lock, [this]() { return counter > 0; });
+				counter--;
+				return;
+			}
+
+			resource.acquire();
+		}
+
+		// Tries to acquire a permit without waiting. Returns true if it was acquired, else false.
+		bool try_acquire() noexcept
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				if (counter == 0)
+				{
+					return false;
+				}
+
+				counter--;
+				return true;
+			}
+
+			return resource.try_acquire();
+		}
+
+		// Tries to acquire a permit, waiting until one is available or until the specified duration
+		// elapses. While controlled, the duration elapses in the virtual time of the scheduler. Returns
+		// true if a permit was acquired, else false.
+		template <class Rep, class Period>
+		bool try_acquire_for(const std::chrono::duration<Rep, Period>& duration)
+		{
+			if (!resource.is_controlled())
+			{
+				std::unique_lock<std::mutex> lock(native_mutex);
+				if (!native_cv.wait_for(lock, duration, [this]() { return counter > 0; }))
+				{
+					return false;
+				}
+
+				counter--;
+				return true;
+			}
+
+			bool is_acquired = false;
+			resource.try_acquire_for(std::chrono::duration_cast<std::chrono::nanoseconds>(duration), is_acquired);
+			return is_acquired;
+		}
+	};
+
+	// A semaphore with a single permit, with the interface of the C++20 'std::binary_semaphore'.
+	using binary_semaphore = counting_semaphore<1>;
+}
+
+#endif // COYOTE_SEMAPHORE_H
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SHARED_MUTEX_H
+#define COYOTE_SHARED_MUTEX_H
+
+#include <shared_mutex>
+#include "controlled_resource.h"
+
+namespace coyote
+{
+	// A reader-writer mutex with the interface of 'std::shared_mutex' that is controlled by the
+	// scheduler, or that uses a 'std::shared_mutex' if scheduling is disabled. Which waiting writer
+	// or readers acquire the mutex after it is released is decided by the exploration strategy.
+	class shared_mutex
+	{
+	private:
+		ControlledResource resource;
+
+		// True if the mutex is exclusively acquired while it is controlled, else false.
+		bool is_locked;
+
+		// The count of shared owners while the mutex is controlled.
+		size_t shared_count;
+
+		// The native mutex, which is used if scheduling is disabled.
+		std::shared_mutex native_mutex;
+
+	public:
+		shared_mutex(Scheduler* scheduler) noexcept :
+			resource(scheduler),
+			is_locked(false),
+			shared_count(0)
+		{
+		}
+
+		shared_mutex(shared_mutex&& m) = delete;
+		shared_mutex(shared_mutex const&) = delete;
+
+		shared_mutex& operator=(shared_mutex&& m) = delete;
+		shared_mutex& operator=(shared_mutex const&) = delete;
+
+		// Acquires exclusive ownership of the mutex, waiting until it is available.
+		void lock()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.lock();
+				return;
+			}
+
+			resource.schedule_next();
+			while ((is_locked || shared_count > 0) && resource.wait())
+			{
+			}
+
+			is_locked = true;
+		}
+
+		// Tries to acquire exclusive ownership of the mutex without waiting. Returns true if it was
+		// acquired, else false.
+		bool try_lock()
+		{
+			if (!resource.is_controlled())
+			{
+				return native_mutex.try_lock();
+			}
+
+			resource.schedule_next();
+			if (is_locked || shared_count > 0)
+			{
+				return false;
+			}
+
+			is_locked = true;
+			return true;
+		}
+
+		// Releases exclusive ownership of the mutex.
+		void unlock()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.unlock();
+				return;
+			}
+
+			is_locked = false;
+			resource.signal();
+		}
+
+		// Acquires shared ownership of the mutex, waiting until it is available.
+		void lock_shared()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.lock_shared();
+				return;
+			}
+
+			resource.schedule_next();
+			while (is_locked && resource.wait())
+			{
+			}
+
+			shared_count++;
+		}
+
+		// Tries to acquire shared ownership of the mutex without waiting. Returns true if it was
+		// acquired, else false.
+		bool try_lock_shared()
+		{
+			if (!resource.is_controlled())
+			{
+				return native_mutex.try_lock_shared();
+			}
+
+			resource.schedule_next();
+			if (is_locked)
+			{
+				return false;
+			}
+
+			shared_count++;
+			return true;
+		}
+
+		// Releases shared ownership of the mutex.
+		void unlock_shared()
+		{
+			if (!resource.is_controlled())
+			{
+				native_mutex.unlock_shared();
+				return;
+			}
+
+			shared_count--;
+			if (shared_count == 0)
+			{
+				resource.signal();
+			}
+		}
+	};
+}
+
+#endif // COYOTE_SHARED_MUTEX_H
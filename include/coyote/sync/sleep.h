@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SLEEP_H
+#define COYOTE_SLEEP_H
+
+#include <chrono>
+#include <thread>
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// Blocks the current operation for the specified duration of virtual time, while the scheduler
+	// controls it, which does not block the thread, or blocks the thread with 'std::this_thread::sleep_for'
+	// if scheduling is disabled.
+	template <class Rep, class Period>
+	void sleep_for(Scheduler* scheduler, const std::chrono::duration<Rep, Period>& duration)
+	{
+		if (!scheduler->is_enabled())
+		{
+			std::this_thread::sleep_for(duration);
+			return;
+		}
+
+		scheduler->sleep_for(std::chrono::duration_cast<std::chrono::nanoseconds>(duration));
+	}
+}
+
+#endif // COYOTE_SLEEP_H
@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_THREAD_H
+#define COYOTE_THREAD_H
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "thread_pool.h"
+
+namespace coyote
+{
+	// A thread with the interface of 'std::thread' that runs as a controlled operation. The scheduler
+	// assigns the id of the operation, the operation is started before the function runs and completed
+	// after it returns, and 'join' waits for the operation through the scheduler. The thread can run on
+	// a new native thread, or on a recycled thread of a 'coyote::thread_pool'. If scheduling is disabled,
+	// the function runs on a native thread without an operation.
+	class thread
+	{
+	private:
+		// Runs the function of a thread as the operation with the specified id.
+		template <class Function>
+		class operation_task : public thread_pool::task
+		{
+		private:
+			Scheduler* scheduler;
+			size_t operation_id;
+			Function function;
+
+		public:
+			operation_task(Scheduler* s, size_t id, Function&& f) :
+				scheduler(s),
+				operation_id(id),
+				function(std::move(f))
+			{
+			}
+
+			void run() override
+			{
+				if (operation_id != main_operation_id)
+				{
+					scheduler->start_operation(operation_id);
+					function();
+					scheduler->complete_operation(operation_id);
+				}
+				else
+				{
+					function();
+				}
+			}
+		};
+
+		// The operation id of a thread that does not run as an operation.
+		static constexpr size_t main_operation_id = 0;
+
+		// The scheduler that controls the thread, if it has one, else null.
+		Scheduler* scheduler;
+
+		// The pool that runs the thread, if it has one, else null.
+		thread_pool* pool;
+
+		// The id of the operation of the thread, or '0' if it does not run as an operation.
+		size_t op_id;
+
+		// The native thread, if the thread does not run on a pool.
+		std::thread native_thread;
+
+		// The task that runs on the pool, if the thread runs on a pool, else null.
+		std::shared_ptr<thread_pool::task> pool_task;
+
+	public:
+		thread() noexcept :
+			scheduler(nullptr),
+			pool(nullptr),
+			op_id(main_operation_id)
+		{
+		}
+
+		// Creates a thread controlled by the specified scheduler that runs the specified function.
+		template <class Function, class... Args>
+		explicit thread(Scheduler* s, Function&& f, Args&&... args) :
+			scheduler(s),
+			pool(nullptr),
+			op_id(main_operation_id)
+		{
+			std::shared_ptr<thread_pool::task> t = create_task(std::forward<Function>(f), std::forward<Args>(args)...);
+			native_thread = std::thread([t]() { t->run(); });
+		}
+
+		// Creates a thread controlled by the scheduler of the specified pool that runs the specified
+		// function on a thread of the pool.
+		template <class Function, class... Args>
+		explicit thread(thread_pool& p, Function&& f, Args&&... args) :
+			scheduler(p.scheduler()),
+			pool(&p),
+			op_id(main_operation_id)
+		{
+			pool_task = create_task(std::forward<Function>(f), std::forward<Args>(args)...);
+			pool->submit(pool_task);
+		}
+
+		thread(thread&& other) noexcept :
+			scheduler(other.scheduler),
+			pool(other.pool),
+			op_id(other.op_id),
+			native_thread(std::move(other.native_thread)),
+			pool_task(std::move(other.pool_task))
+		{
+			other.op_id = main_operation_id;
+		}
+
+		thread(thread const&) = delete;
+
+		thread& operator=(thread&& other) noexcept
+		{
+			if (joinable())
+			{
+				std::terminate();
+			}
+
+			scheduler = other.scheduler;
+			pool = other.pool;
+			op_id = other.op_id;
+			native_thread = std::move(other.native_thread);
+			pool_task = std::move(other.pool_task);
+			other.op_id = main_operation_id;
+			return *this;
+		}
+
+		thread& operator=(thread const&) = delete;
+
+		~thread()
+		{
+			if (joinable())
+			{
+				std::terminate();
+			}
+		}
+
+		// Returns true if the thread is running and has not been joined or detached, else false.
+		bool joinable() const noexcept
+		{
+			return native_thread.joinable() || pool_task != nullptr;
+		}
+
+		// Returns the id of the native thread that runs the thread.
+		std::thread::id get_id() const noexcept
+		{
+			return pool_task != nullptr ? pool->thread_id(pool_task) : native_thread.get_id();
+		}
+
+		// Returns the id of the operation of the thread, or '0' if it does not run as an operation.
+		size_t operation_id() const noexcept
+		{
+			return op_id;
+		}
+
+		// Waits until the thread completes. While controlled, the calling operation waits for the
+		// operation of the thread through the scheduler.
+		void join()
+		{
+			if (!joinable())
+			{
+				throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+			}
+
+			if (op_id != main_operation_id)
+			{
+				scheduler->join_operation(op_id);
+				op_id = main_operation_id;
+			}
+
+			if (pool_task != nullptr)
+			{
+				pool->wait(pool_task);
+				pool_task = nullptr;
+			}
+			else
+			{
+				native_thread.join();
+			}
+		}
+
+		// Separates the thread from this object, so that it runs independently.
+		void detach()
+		{
+			if (!joinable())
+			{
+				throw std::system_error(std::make_error_code(std::errc::invalid_argument));
+			}
+
+			op_id = main_operation_id;
+			if (pool_task != nullptr)
+			{
+				pool_task = nullptr;
+			}
+			else
+			{
+				native_thread.detach();
+			}
+		}
+
+		void swap(thread& other) noexcept
+		{
+			std::swap(scheduler, other.scheduler);
+			std::swap(pool, other.pool);
+			std::swap(op_id, other.op_id);
+			std::swap(native_thread, other.native_thread);
+			std::swap(pool_task, other.pool_task);
+		}
+
+		static unsigned int hardware_concurrency() noexcept
+		{
+			return std::thread::hardware_concurrency();
+		}
+
+	private:
+		// Creates the operation of the thread, if the scheduler is attached, and returns the task that
+		// runs the function with the specified arguments as that operation.
+		template <class Function, class... Args>
+		std::shared_ptr<thread_pool::task> create_task(Function&& f, Args&&... args)
+		{
+			// The id is only assigned if the operation was created, as the returned error code is sticky.
+			op_id = main_operation_id;
+			if (scheduler->is_enabled() && scheduler->is_client_attached())
+			{
+				scheduler->create_unique_operation(op_id);
+			}
+
+			auto function = [f = std::decay_t<Function>(std::forward<Function>(f)),
+				args = std::make_tuple(std::decay_t<Args>(std::forward<Args>(args))...)]() mutable
+			{
+				std::apply(std::move(f), std::move(args));
+			};
+
+			return std::make_shared<operation_task<decltype(function)>>(scheduler, op_id, std::move(function));
+		}
+	};
+}
+
+#endif // COYOTE_THREAD_H
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_THREAD_POOL_H
+#define COYOTE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// A pool of native threads that run the work of 'coyote::thread' objects, so that testing iterations
+	// reuse threads instead of creating new ones. The pool grows whenever all of its threads are busy,
+	// because a controlled operation must start running as soon as it is created. The pool must outlive
+	// the threads that run on it.
+	class thread_pool
+	{
+	public:
+		// Work that runs on a thread of the pool.
+		class task
+		{
+			friend class thread_pool;
+
+		private:
+			// The id of the native thread that runs the work.
+			std::thread::id thread_id;
+
+			// True if the work has completed, else false.
+			bool is_done;
+
+		public:
+			task() noexcept :
+				thread_id(),
+				is_done(false)
+			{
+			}
+
+			virtual ~task() = default;
+
+			// Runs the work.
+			virtual void run() = 0;
+		};
+
+	private:
+		// A native thread of the pool, which runs one task at a time.
+		struct worker
+		{
+			// The native thread.
+			std::thread thread;
+
+			// The next task to run, if assigned, else null.
+			std::shared_ptr<task> next_task;
+
+			// Conditional variable that is notified when a task is assigned or the pool stops.
+			std::condition_variable cv;
+		};
+
+		// The scheduler that controls the threads of the pool.
+		Scheduler* const pool_scheduler;
+
+		// Mutex that synchronizes access to the pool.
+		std::mutex mutex;
+
+		// Conditional variable that is notified when a task completes.
+		std::condition_variable done_cv;
+
+		// The threads of the pool.
+		std::vector<std::unique_ptr<worker>> workers;
+
+		// The threads of the pool that are waiting for a task.
+		std::vector<worker*> idle_workers;
+
+		// True if the pool is stopping, else false.
+		bool is_stopped;
+
+	public:
+		thread_pool(Scheduler* scheduler) noexcept :
+			pool_scheduler(scheduler),
+			is_stopped(false)
+		{
+		}
+
+		thread_pool(thread_pool&& pool) = delete;
+		thread_pool(thread_pool const&) = delete;
+
+		thread_pool& operator=(thread_pool&& pool) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		~thread_pool()
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				is_stopped = true;
+				for (auto& w : workers)
+				{
+					w->cv.notify_all();
+				}
+			}
+
+			for (auto& w : workers)
+			{
+				w->thread.join();
+			}
+		}
+
+		// Returns the scheduler that controls the threads of the pool.
+		Scheduler* scheduler() const noexcept
+		{
+			return pool_scheduler;
+		}
+
+		// Returns the number of native threads that the pool has created.
+		size_t size()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			return workers.size();
+		}
+
+		// Runs the specified task on an idle thread of the pool, or on a new thread if all are busy.
+		void submit(const std::shared_ptr<task>& t)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			worker* w;
+			if (idle_workers.empty())
+			{
+				workers.push_back(std::make_unique<worker>());
+				w = workers.back().get();
+				w->thread = std::thread(&thread_pool::run_worker, this, w);
+			}
+			else
+			{
+				w = idle_workers.back();
+				idle_workers.pop_back();
+			}
+
+			t->thread_id = w->thread.get_id();
+			w->next_task = t;
+			w->cv.notify_all();
+		}
+
+		// Waits until the specified task has completed.
+		void wait(const std::shared_ptr<task>& t)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			done_cv.wait(lock, [&t]() { return t->is_done; });
+		}
+
+		// Returns the id of the native thread that runs the specified task.
+		std::thread::id thread_id(const std::shared_ptr<task>& t)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			return t->thread_id;
+		}
+
+	private:
+		void run_worker(worker* w)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true)
+			{
+				w->cv.wait(lock, [this, w]() { return w->next_task != nullptr || is_stopped; });
+				if (w->next_task == nullptr)
+				{
+					return;
+				}
+
+				std::shared_ptr<task> t = std::move(w->next_task);
+				w->next_task = nullptr;
+				lock.unlock();
+				t->run();
+				lock.lock();
+
+				t->is_done = true;
+				done_cv.notify_all();
+				idle_workers.push_back(w);
+			}
+		}
+	};
+}
+
+#endif // COYOTE_THREAD_POOL_H
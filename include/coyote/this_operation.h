@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_THIS_OPERATION_H
+#define COYOTE_THIS_OPERATION_H
+
+#include <cstdint>
+#include "scheduler.h"
+
+namespace coyote
+{
+	// Functions that act on the operation that the calling thread started, similar to 'std::this_thread',
+	// so that the caller does not need to track the scheduler or the operation id.
+	namespace this_operation
+	{
+		// The id that is returned if the calling thread has not started an operation.
+		constexpr size_t invalid_id = SIZE_MAX;
+
+		// Returns the scheduler that controls the operation of the calling thread, or null.
+		inline Scheduler* scheduler() noexcept
+		{
+			return Scheduler::current_scheduler();
+		}
+
+		// Returns the id of the operation of the calling thread, or 'invalid_id' if there is none.
+		inline size_t id() noexcept
+		{
+			size_t operation_id;
+			Scheduler* s = Scheduler::current_scheduler();
+			return s != nullptr && s->current_operation_id(operation_id) ? operation_id : invalid_id;
+		}
+
+		// Schedules the next operation, which can include the operation of the calling thread.
+		inline ErrorCode yield() noexcept
+		{
+			Scheduler* s = Scheduler::current_scheduler();
+			return s != nullptr ? s->schedule_next() : ErrorCode::OperationNotStarted;
+		}
+
+		// Completes the operation of the calling thread and schedules the next operation.
+		inline ErrorCode complete() noexcept
+		{
+			Scheduler* s = Scheduler::current_scheduler();
+			return s != nullptr ? s->complete_operation() : ErrorCode::OperationNotStarted;
+		}
+	}
+}
+
+#endif // COYOTE_THIS_OPERATION_H
@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CHROME_TRACE_WRITER_H
+#define COYOTE_CHROME_TRACE_WRITER_H
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "trace_event.h"
+#include "trace_sink.h"
+
+namespace coyote
+{
+	// Streams the explored schedules to a file in the Chrome trace-event JSON format, which can be
+	// opened in Perfetto (ui.perfetto.dev) or chrome://tracing. Each testing iteration is a process and
+	// each operation is a thread track, with a span for each stretch that the operation was scheduled.
+	// Flow arrows link the operation that created, signaled or completed to the operations that it
+	// enabled. Timestamps are logical, so each event advances the time by one microsecond.
+	//
+	// Events are written as they arrive, so the memory usage does not grow with the schedule length.
+	class ChromeTraceWriter : public TraceSink
+	{
+	private:
+		// The output file.
+		std::ofstream stream;
+
+		// True if no event has been written yet, else false.
+		bool is_empty;
+
+		// The current testing iteration.
+		uint64_t iteration;
+
+		// True if an operation is currently scheduled, else false.
+		bool is_running;
+
+		// The id of the currently scheduled operation.
+		uint64_t running_op_id;
+
+		// The id of the operation that signaled the last resource, if it is still enabling operations.
+		bool is_signaling;
+		uint64_t signaling_op_id;
+		uint64_t signaled_resource_id;
+
+		// The id of the next flow arrow.
+		uint64_t next_flow_id;
+
+		// Map from operation ids to the flow arrows that end when they are next scheduled.
+		std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, std::string>>> pending_flows;
+
+		// Operations whose track has been named in the current testing iteration.
+		std::unordered_set<uint64_t> named_operations;
+
+	public:
+		ChromeTraceWriter(const std::string& file_path) :
+			stream(file_path, std::ios::out | std::ios::trunc),
+			is_empty(true),
+			iteration(0),
+			is_running(false),
+			running_op_id(0),
+			is_signaling(false),
+			signaling_op_id(0),
+			signaled_resource_id(0),
+			next_flow_id(1)
+		{
+			if (!stream.is_open())
+			{
+				throw std::runtime_error("could not open the trace file");
+			}
+
+			stream << "[";
+		}
+
+		~ChromeTraceWriter()
+		{
+			stream << "\n]\n";
+		}
+
+		ChromeTraceWriter(ChromeTraceWriter&& writer) = delete;
+		ChromeTraceWriter(ChromeTraceWriter const&) = delete;
+
+		ChromeTraceWriter& operator=(ChromeTraceWriter&& writer) = delete;
+		ChromeTraceWriter& operator=(ChromeTraceWriter const&) = delete;
+
+		void write(const TraceEvent& event)
+		{
+			if (event.type != TraceEventType::OperationEnabled)
+			{
+				is_signaling = false;
+			}
+
+			const uint64_t ts = event.sequence;
+			switch (event.type)
+			{
+			case TraceEventType::IterationStarted:
+				iteration = event.operation_id;
+				is_running = false;
+				pending_flows.clear();
+				named_operations.clear();
+				begin_event("process_name", "M", 0, 0);
+				stream << ",\"args\":{\"name\":\"iteration " << iteration << "\"}}";
+				break;
+			case TraceEventType::IterationCompleted:
+				end_running_span(ts);
+				break;
+			case TraceEventType::OperationCreated:
+				name_track(event.operation_id);
+				if (event.target_id != event.operation_id)
+				{
+					instant("create operation " + std::to_string(event.operation_id), event.target_id, ts);
+					start_flow("create", event.target_id, event.operation_id, ts);
+				}
+
+				break;
+			case TraceEventType::OperationStarted:
+				name_track(event.operation_id);
+				break;
+			case TraceEventType::OperationScheduled:
+				end_running_span(ts);
+				begin_event("scheduled", "B", event.operation_id, ts);
+				stream << "}";
+				is_running = true;
+				running_op_id = event.operation_id;
+				finish_flows(event.operation_id, ts);
+				break;
+			case TraceEventType::OperationWaitingResource:
+				instant("wait resource " + std::to_string(event.target_id), event.operation_id, ts);
+				break;
+			case TraceEventType::OperationJoining:
+				instant("join operation " + std::to_string(event.target_id), event.operation_id, ts);
+				break;
+			case TraceEventType::OperationEnabled:
+				if (is_signaling && signaling_op_id == event.target_id)
+				{
+					start_flow("signal resource " + std::to_string(signaled_resource_id), event.target_id,
+						event.operation_id, ts);
+				}
+				else
+				{
+					start_flow("complete operation " + std::to_string(event.target_id), event.target_id,
+						event.operation_id, ts);
+				}
+
+				break;
+			case TraceEventType::OperationCompleted:
+				instant("complete", event.operation_id, ts);
+				if (is_running && running_op_id == event.operation_id)
+				{
+					end_running_span(ts);
+				}
+
+				break;
+			case TraceEventType::ResourceSignaled:
+				instant("signal resource " + std::to_string(event.target_id), event.operation_id, ts);
+				is_signaling = true;
+				signaling_op_id = event.operation_id;
+				signaled_resource_id = event.target_id;
+				break;
+			case TraceEventType::DeadlockDetected:
+				instant("deadlock detected", event.operation_id, ts);
+				break;
+			case TraceEventType::OperationWaitingTimer:
+				instant("wait timer " + std::to_string(event.target_id) + "ns", event.operation_id, ts);
+				break;
+			case TraceEventType::TimerFired:
+				instant("timer fired at " + std::to_string(event.target_id) + "ns", event.operation_id, ts);
+				break;
+			case TraceEventType::PotentialLivelockDetected:
+				instant("potential livelock detected after " + std::to_string(event.target_id) + " steps",
+					event.operation_id, ts);
+				break;
+			}
+		}
+
+		void flush()
+		{
+			stream.flush();
+		}
+
+	private:
+		// Writes the common fields of an event, leaving the JSON object open.
+		void begin_event(const std::string& name, const char* phase, uint64_t operation_id, uint64_t ts)
+		{
+			stream << (is_empty ? "\n" : ",\n");
+			is_empty = false;
+			stream << "{\"name\":\"" << name << "\",\"ph\":\"" << phase << "\",\"pid\":" << iteration <<
+				",\"tid\":" << operation_id << ",\"ts\":" << ts;
+		}
+
+		void name_track(uint64_t operation_id)
+		{
+			if (named_operations.insert(operation_id).second)
+			{
+				begin_event("thread_name", "M", operation_id, 0);
+				stream << ",\"args\":{\"name\":\"operation " << operation_id << "\"}}";
+			}
+		}
+
+		void instant(const std::string& name, uint64_t operation_id, uint64_t ts)
+		{
+			begin_event(name, "i", operation_id, ts);
+			stream << ",\"s\":\"t\"}";
+		}
+
+		void end_running_span(uint64_t ts)
+		{
+			if (is_running)
+			{
+				begin_event("scheduled", "E", running_op_id, ts);
+				stream << "}";
+				is_running = false;
+			}
+		}
+
+		// Starts a flow arrow from the source operation that ends when the target operation is next scheduled.
+		void start_flow(const std::string& name, uint64_t source_op_id, uint64_t target_op_id, uint64_t ts)
+		{
+			uint64_t flow_id = next_flow_id++;
+			begin_event(name, "s", source_op_id, ts);
+			stream << ",\"cat\":\"flow\",\"id\":" << flow_id << "}";
+			pending_flows[target_op_id].push_back(std::make_pair(flow_id, name));
+		}
+
+		void finish_flows(uint64_t operation_id, uint64_t ts)
+		{
+			auto it = pending_flows.find(operation_id);
+			if (it != pending_flows.end())
+			{
+				for (const auto& flow : it->second)
+				{
+					begin_event(flow.second, "f", operation_id, ts);
+					stream << ",\"cat\":\"flow\",\"bp\":\"e\",\"id\":" << flow.first << "}";
+				}
+
+				pending_flows.erase(it);
+			}
+		}
+	};
+}
+
+#endif // COYOTE_CHROME_TRACE_WRITER_H
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_EVENT_H
+#define COYOTE_TRACE_EVENT_H
+
+#include <cstdint>
+
+namespace coyote
+{
+	enum class TraceEventType : uint32_t
+	{
+		// A testing iteration started. The operation id is the iteration.
+		IterationStarted = 0,
+		// A testing iteration completed. The operation id is the iteration.
+		IterationCompleted,
+		// An operation was created by the target operation.
+		OperationCreated,
+		// An operation started executing.
+		OperationStarted,
+		// An operation was scheduled after the target operation.
+		OperationScheduled,
+		// An operation is waiting the target resource to be signaled.
+		OperationWaitingResource,
+		// An operation is waiting the target operation to complete.
+		OperationJoining,
+		// An operation was enabled by the target operation, which signaled a resource or completed.
+		OperationEnabled,
+		// An operation completed.
+		OperationCompleted,
+		// An operation signaled the target resource.
+		ResourceSignaled,
+		// A deadlock was detected while the operation was scheduled.
+		DeadlockDetected,
+		// An operation is waiting a timer that fires after the target duration in nanoseconds.
+		OperationWaitingTimer,
+		// The timer of an operation fired, which enabled it. The target is the virtual time in nanoseconds.
+		TimerFired,
+		// The testing iteration exceeded its bounds while the operation was scheduled, which is a potential
+		// livelock. The target is the number of steps.
+		PotentialLivelockDetected
+	};
+
+	// An event of the explored schedule. The layout is fixed, so events can be shared without copies.
+	struct TraceEvent
+	{
+		// The type of the event.
+		TraceEventType type;
+
+		// Reserved for alignment.
+		uint32_t reserved;
+
+		// The order of the event in the testing iteration, starting from zero.
+		uint64_t sequence;
+
+		// The id of the operation that the event is about.
+		uint64_t operation_id;
+
+		// The id of the operation or resource that the event refers to, depending on the type.
+		uint64_t target_id;
+	};
+}
+
+#endif // COYOTE_TRACE_EVENT_H
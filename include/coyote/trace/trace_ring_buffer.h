@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_RING_BUFFER_H
+#define COYOTE_TRACE_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "trace_event.h"
+#include "trace_sink.h"
+
+namespace coyote
+{
+	// The shared header of a trace ring buffer. The layout is part of the ABI, and consists of five
+	// 64-bit fields in declaration order, so a host can read events directly from memory: the events
+	// start 'events_offset' bytes after the start of the header, the event with sequence number 'n' in
+	// the buffer is at index 'n % capacity', and the events between the read and write cursors are
+	// available. The scheduler only advances the write cursor, and the host only advances the read cursor.
+	struct TraceRingBufferHeader
+	{
+		// The number of events written so far. Advanced with release semantics after an event is stored.
+		std::atomic<uint64_t> write_cursor;
+
+		// The number of events consumed so far. Advanced by the host after it has read events.
+		std::atomic<uint64_t> read_cursor;
+
+		// The number of events that the buffer can hold.
+		uint64_t capacity;
+
+		// The number of events that were dropped because the buffer was full.
+		std::atomic<uint64_t> dropped_count;
+
+		// The offset in bytes of the events from the start of the header, in the same memory. This is an
+		// offset instead of a pointer, so the header has the same layout in every process and address
+		// space that maps the memory.
+		uint64_t events_offset;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "the cursors must be lock-free to be shared.");
+	static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "the cursors must have a fixed layout.");
+	static_assert(sizeof(TraceRingBufferHeader) == 5 * sizeof(uint64_t), "the header must have a fixed layout.");
+	static_assert(alignof(TraceRingBufferHeader) <= alignof(TraceEvent), "the header must fit the alignment of the events.");
+
+	// Stores the events of the explored schedules in a fixed-capacity single-producer single-consumer
+	// ring buffer, which a host can consume concurrently through the shared header without copies or
+	// per-event calls. If the host falls behind and the buffer is full, new events are dropped and
+	// counted instead of blocking the scheduler.
+	//
+	// The header and events are either stored in memory owned by the ring buffer, or in memory that
+	// the host registers and owns, which stays valid after the ring buffer is replaced or destroyed.
+	class TraceRingBuffer : public TraceSink
+	{
+	private:
+		// The offset of the events from the start of the memory of the buffer.
+		static constexpr size_t EVENTS_OFFSET =
+			(sizeof(TraceRingBufferHeader) + alignof(TraceEvent) - 1) / alignof(TraceEvent) * alignof(TraceEvent);
+
+		// The memory of the header and events, if it is owned by the ring buffer.
+		std::unique_ptr<TraceEvent[]> storage;
+
+		// The shared header, which is stored at the start of the memory of the buffer.
+		TraceRingBufferHeader* shared_header;
+
+	public:
+		// Creates a ring buffer with the specified capacity in events, in memory that it owns.
+		TraceRingBuffer(size_t capacity) :
+			storage(std::make_unique<TraceEvent[]>((required_size(std::max<size_t>(capacity, 1)) +
+				sizeof(TraceEvent) - 1) / sizeof(TraceEvent)))
+		{
+			initialize(storage.get(), std::max<size_t>(capacity, 1));
+		}
+
+		// Creates a ring buffer in the specified memory of the specified size in bytes, which is owned
+		// by the host and must be aligned for a 'TraceRingBufferHeader'. The capacity is the number of
+		// events that fit in the memory after the header.
+		TraceRingBuffer(void* memory, size_t size) :
+			shared_header(nullptr)
+		{
+			if (memory == nullptr || reinterpret_cast<uintptr_t>(memory) % alignof(TraceRingBufferHeader) != 0 ||
+				size < required_size(1))
+			{
+				throw std::invalid_argument("received memory that cannot hold a trace ring buffer");
+			}
+
+			initialize(memory, (size - EVENTS_OFFSET) / sizeof(TraceEvent));
+		}
+
+		TraceRingBuffer(TraceRingBuffer&& buffer) = delete;
+		TraceRingBuffer(TraceRingBuffer const&) = delete;
+
+		TraceRingBuffer& operator=(TraceRingBuffer&& buffer) = delete;
+		TraceRingBuffer& operator=(TraceRingBuffer const&) = delete;
+
+		// Returns the number of bytes of memory that a ring buffer with the specified capacity in
+		// events requires.
+		static constexpr size_t required_size(size_t capacity) noexcept
+		{
+			return EVENTS_OFFSET + capacity * sizeof(TraceEvent);
+		}
+
+		// Returns the shared header, which is valid for the lifetime of the memory of the ring buffer.
+		TraceRingBufferHeader* header() noexcept
+		{
+			return shared_header;
+		}
+
+		void write(const TraceEvent& event) override
+		{
+			uint64_t write_cursor = shared_header->write_cursor.load(std::memory_order_relaxed);
+			uint64_t read_cursor = shared_header->read_cursor.load(std::memory_order_acquire);
+			if (write_cursor - read_cursor >= shared_header->capacity)
+			{
+				shared_header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			event_at(write_cursor) = event;
+			shared_header->write_cursor.store(write_cursor + 1, std::memory_order_release);
+		}
+
+		// Reads the next available event, if there is one. This is the consumer side of the buffer, for
+		// hosts that are written in C++.
+		bool try_read(TraceEvent& event) noexcept
+		{
+			uint64_t read_cursor = shared_header->read_cursor.load(std::memory_order_relaxed);
+			if (read_cursor == shared_header->write_cursor.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			event = event_at(read_cursor);
+			shared_header->read_cursor.store(read_cursor + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		// Places the header at the start of the specified memory, followed by the specified number of events.
+		void initialize(void* memory, size_t capacity) noexcept
+		{
+			shared_header = new (memory) TraceRingBufferHeader;
+			shared_header->write_cursor.store(0, std::memory_order_relaxed);
+			shared_header->read_cursor.store(0, std::memory_order_relaxed);
+			shared_header->capacity = capacity;
+			shared_header->dropped_count.store(0, std::memory_order_relaxed);
+			shared_header->events_offset = EVENTS_OFFSET;
+		}
+
+		// Returns the slot of the event with the specified sequence number in the buffer.
+		TraceEvent& event_at(uint64_t sequence) noexcept
+		{
+			TraceEvent* events = reinterpret_cast<TraceEvent*>(reinterpret_cast<unsigned char*>(shared_header) +
+				shared_header->events_offset);
+			return events[sequence % shared_header->capacity];
+		}
+	};
+}
+
+#endif // COYOTE_TRACE_RING_BUFFER_H
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_SINK_H
+#define COYOTE_TRACE_SINK_H
+
+#include "trace_event.h"
+
+namespace coyote
+{
+	// Receives the events of the explored schedules. The scheduler writes events while holding its
+	// lock, so sinks must not call back into the scheduler.
+	class TraceSink
+	{
+	public:
+		virtual ~TraceSink() = default;
+
+		// Writes the specified event.
+		virtual void write(const TraceEvent& event) = 0;
+
+		// Flushes any buffered events. Invoked at the end of each testing iteration.
+		virtual void flush()
+		{
+		}
+	};
+}
+
+#endif // COYOTE_TRACE_SINK_H
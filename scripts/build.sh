@@ -1,17 +1,25 @@
 #!/bin/bash
 
-echo "Building the Coyote native scheduler..."
+# The build type is Release by default, and each other build type is built in its own directory.
+build_type=${1:-Release}
+build_dir=./build
+if [ "$build_type" != "Release" ]
+then
+  build_dir=./build-${build_type,,}
+fi
+
+echo "Building the Coyote native scheduler ($build_type)..."
 
 # Install ninja build dependency, if it does not already exist
 sudo apt-get install ninja-build -y
 
 # Create build directory
-rm -r ./build
-mkdir ./build
-cd ./build
+rm -r $build_dir
+mkdir $build_dir
+cd $build_dir
 
 # Build the project
-cmake -G "Ninja" -DCMAKE_BUILD_TYPE=Release ..
+cmake -G "Ninja" -DCMAKE_BUILD_TYPE=$build_type ..
 retVal=$?
 if [ $retVal -eq 0 ]
 then
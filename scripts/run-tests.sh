@@ -1,8 +1,13 @@
 #!/bin/bash
 
+# Runs the tests of the specified build directory, which is './build' by default, and passes any
+# further arguments to ctest, such as '-R interposed' to only run the matching tests.
+build_dir=${1:-./build}
+shift
+
 echo "Running the Coyote native scheduler tests..."
 
-cd ./build
+cd $build_dir
 retVal=$?
 if [ $retVal -ne 0 ]
 then
@@ -10,7 +15,7 @@ then
  exit $retVal
 fi
 
-ctest
+ctest "$@"
 retVal=$?
 if [ $retVal -eq 0 ]
 then
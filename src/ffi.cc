@@ -3,6 +3,9 @@
 
 #include "ffi.h"
 #include "scheduler.h"
+#include "this_operation.h"
+#include "trace/chrome_trace_writer.h"
+#include "trace/trace_ring_buffer.h"
 
 using namespace coyote;
 
@@ -27,6 +30,41 @@ extern "C"
         return new Scheduler(std::move(settings));
     }
 
+    COYOTE_API void* create_scheduler_with_adaptive_pct_strategy(uint64_t seed, size_t min_bound, size_t max_bound)
+    {
+        try
+        {
+            auto settings = std::make_unique<Settings>();
+            settings->use_adaptive_pct_strategy(seed, min_bound, max_bound);
+            return new Scheduler(std::move(settings));
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    COYOTE_API void* create_scheduler_with_pctcp_strategy(uint64_t seed, size_t bound)
+    {
+        auto settings = std::make_unique<Settings>();
+        settings->use_pctcp_strategy(seed, bound);
+        return new Scheduler(std::move(settings));
+    }
+
+    COYOTE_API void* create_scheduler_with_qlearning_strategy(uint64_t seed)
+    {
+        auto settings = std::make_unique<Settings>();
+        settings->use_qlearning_strategy(seed);
+        return new Scheduler(std::move(settings));
+    }
+
+    COYOTE_API void* create_scheduler_with_portfolio_strategy(uint64_t seed)
+    {
+        auto settings = std::make_unique<Settings>();
+        settings->use_portfolio_strategy(seed);
+        return new Scheduler(std::move(settings));
+    }
+
     COYOTE_API int attach(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -48,6 +86,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int create_operation_in_group(void* scheduler, size_t operation_id, size_t group_id)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->create_operation(operation_id, group_id);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int start_operation(void* scheduler, size_t operation_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -76,6 +121,23 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int this_operation_yield()
+    {
+        ErrorCode error_code = this_operation::yield();
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int this_operation_complete()
+    {
+        ErrorCode error_code = this_operation::complete();
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API size_t this_operation_id()
+    {
+        return this_operation::id();
+    }
+
     COYOTE_API int create_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -83,6 +145,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int create_resource_with_permits(void* scheduler, size_t resource_id, size_t permits)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->create_resource(resource_id, permits);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int wait_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -97,6 +166,33 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int wait_resource_for(void* scheduler, size_t resource_id, uint64_t timeout_ns, bool* is_signaled)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->wait_resource_for(resource_id, std::chrono::nanoseconds(timeout_ns), *is_signaled);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int wait_resource_or_timeout(void* scheduler, size_t resource_id, bool* is_signaled)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->wait_resource_for(resource_id, *is_signaled);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int sleep_for(void* scheduler, uint64_t duration_ns)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->sleep_for(std::chrono::nanoseconds(duration_ns));
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API uint64_t virtual_time(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return (uint64_t)ptr->virtual_time().count();
+    }
+
     COYOTE_API int signal_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -104,6 +200,50 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int acquire_resource(void* scheduler, size_t resource_id)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->acquire_resource(resource_id);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int try_acquire_resource(void* scheduler, size_t resource_id, bool* is_acquired)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->try_acquire_resource(resource_id, *is_acquired);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int acquire_resource_for(void* scheduler, size_t resource_id, uint64_t timeout_ns, bool* is_acquired)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->acquire_resource_for(resource_id, std::chrono::nanoseconds(timeout_ns), *is_acquired);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int release_resource(void* scheduler, size_t resource_id)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->release_resource(resource_id);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int execute_batch(void* scheduler, const Command* commands, size_t size, int* error_codes)
+    {
+        // Error codes are written in place, as an enum has the representation of its underlying type.
+        static_assert(sizeof(ErrorCode) == sizeof(int), "error codes must have the size of an int.");
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->execute_batch(commands, size, reinterpret_cast<ErrorCode*>(error_codes));
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int create_lock(void* scheduler, size_t resource_id)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->create_lock(resource_id);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int delete_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -130,6 +270,12 @@ extern "C"
         return ptr->next_integer(max_value);
     }
 
+    COYOTE_API void notify_bug_found(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ptr->notify_bug_found();
+    }
+
     COYOTE_API int scheduled_operation_id(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -142,6 +288,31 @@ extern "C"
         return ptr->random_seed();
     }
 
+    COYOTE_API int exploration_strategy(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        StrategyType strategy_type = ptr->exploration_strategy();
+        return static_cast<std::underlying_type_t<StrategyType>>(strategy_type);
+    }
+
+    COYOTE_API size_t exploration_strategy_bound(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->exploration_strategy_bound();
+    }
+
+    COYOTE_API uint64_t exploration_strategy_seed(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->exploration_strategy_seed();
+    }
+
+    COYOTE_API size_t exploration_strategy_iteration(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->exploration_strategy_iteration();
+    }
+
     COYOTE_API int error_code(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -149,6 +320,175 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API size_t iteration_steps(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->iteration_statistics().steps;
+    }
+
+    COYOTE_API size_t iteration_context_switches(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->iteration_statistics().context_switches;
+    }
+
+    COYOTE_API size_t iteration_deadlocks(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->iteration_statistics().deadlocks;
+    }
+
+    COYOTE_API size_t iteration_max_concurrent_operations(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->iteration_statistics().max_concurrent_operations;
+    }
+
+    COYOTE_API size_t iteration_max_enabled_operations(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->iteration_statistics().max_enabled_operations;
+    }
+
+    COYOTE_API size_t total_iterations(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().iterations;
+    }
+
+    COYOTE_API size_t total_steps(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().steps;
+    }
+
+    COYOTE_API size_t total_context_switches(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().context_switches;
+    }
+
+    COYOTE_API size_t total_deadlocks(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().deadlocks;
+    }
+
+    COYOTE_API size_t total_max_concurrent_operations(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().max_concurrent_operations;
+    }
+
+    COYOTE_API size_t total_max_enabled_operations(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->total_statistics().max_enabled_operations;
+    }
+
+    COYOTE_API size_t deadlock_cycle(void* scheduler, WaitForEdge* edges, size_t size)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        std::vector<WaitForEdge> cycle = ptr->deadlock_cycle();
+        std::copy_n(cycle.begin(), std::min(cycle.size(), size), edges);
+        return cycle.size();
+    }
+
+    COYOTE_API const StatisticsSnapshot* statistics_snapshot(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->statistics_snapshot();
+    }
+
+    COYOTE_API int enable_chrome_trace(void* scheduler, const char* file_path)
+    {
+        try
+        {
+            Scheduler* ptr = (Scheduler*)scheduler;
+            ptr->set_trace_sink(std::make_unique<ChromeTraceWriter>(file_path));
+        }
+        catch (...)
+        {
+            return static_cast<std::underlying_type_t<ErrorCode>>(ErrorCode::Failure);
+        }
+
+        return static_cast<std::underlying_type_t<ErrorCode>>(ErrorCode::Success);
+    }
+
+    COYOTE_API size_t trace_ring_buffer_size(size_t capacity)
+    {
+        return TraceRingBuffer::required_size(capacity);
+    }
+
+    COYOTE_API int enable_trace_ring_buffer(void* scheduler, void* buffer, size_t size)
+    {
+        try
+        {
+            Scheduler* ptr = (Scheduler*)scheduler;
+            ptr->set_trace_sink(std::make_unique<TraceRingBuffer>(buffer, size));
+        }
+        catch (...)
+        {
+            return static_cast<std::underlying_type_t<ErrorCode>>(ErrorCode::Failure);
+        }
+
+        return static_cast<std::underlying_type_t<ErrorCode>>(ErrorCode::Success);
+    }
+
+    COYOTE_API void disable_trace(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ptr->set_trace_sink(nullptr);
+    }
+
+    COYOTE_API void set_iteration_bounds(void* scheduler, size_t max_steps, uint64_t max_time_ms, size_t fair_steps)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ptr->set_iteration_bounds(max_steps, std::chrono::milliseconds(max_time_ms), fair_steps);
+    }
+
+    COYOTE_API void enable_latency_profiling(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ptr->enable_latency_profiling();
+    }
+
+    COYOTE_API uint64_t latency_count(void* scheduler, int event)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->latency_histogram(static_cast<LatencyEvent>(event)).count();
+    }
+
+    COYOTE_API double latency_mean(void* scheduler, int event)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->latency_histogram(static_cast<LatencyEvent>(event)).mean();
+    }
+
+    COYOTE_API uint64_t latency_min(void* scheduler, int event)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->latency_histogram(static_cast<LatencyEvent>(event)).min();
+    }
+
+    COYOTE_API uint64_t latency_max(void* scheduler, int event)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->latency_histogram(static_cast<LatencyEvent>(event)).max();
+    }
+
+    COYOTE_API uint64_t latency_percentile(void* scheduler, int event, double percentile)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->latency_histogram(static_cast<LatencyEvent>(event)).percentile(percentile);
+    }
+
+    COYOTE_API void clear_latency_histograms(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ptr->clear_latency_histograms();
+    }
+
     COYOTE_API int dispose_scheduler(void* scheduler)
     {
         try
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_ADDRESS_TABLE_H
+#define COYOTE_ADDRESS_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace coyote
+{
+    // Fixed-capacity lock-free hash table from non-zero keys, such as the addresses of pthread objects
+    // or pthread handles, to values. It uses open addressing with linear probing, and never allocates
+    // or takes a lock, so it can be used from inside the interposed pthread functions. Removed keys
+    // leave a tombstone that can be reused by a later insertion. Lookups stop after the longest probe
+    // distance of any insertion, so misses stay cheap even when tombstones have replaced all empty
+    // entries.
+    template <typename Value, size_t Capacity>
+    class AddressTable
+    {
+    private:
+        static_assert((Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+
+        static constexpr uintptr_t EMPTY_KEY = 0;
+        static constexpr uintptr_t TOMBSTONE_KEY = 1;
+
+        struct Entry
+        {
+            std::atomic<uintptr_t> key;
+            Value value;
+        };
+
+        Entry entries[Capacity];
+
+        // The longest distance from its hashed entry at which a key was inserted. It only grows, and it
+        // grows before the key is stored, so lookups never stop before reaching a stored key.
+        std::atomic<size_t> max_probe_distance;
+
+    public:
+        AddressTable() noexcept :
+            max_probe_distance(0)
+        {
+            for (size_t idx = 0; idx < Capacity; idx++)
+            {
+                entries[idx].key.store(EMPTY_KEY, std::memory_order_relaxed);
+            }
+        }
+
+        AddressTable(AddressTable&& table) = delete;
+        AddressTable(AddressTable const&) = delete;
+
+        AddressTable& operator=(AddressTable&& table) = delete;
+        AddressTable& operator=(AddressTable const&) = delete;
+
+        // Returns the value of the specified key, or null if the key does not exist.
+        Value* find(uintptr_t key) noexcept
+        {
+            size_t idx = hash(key);
+            const size_t max_probe = max_probe_distance.load(std::memory_order_acquire);
+            for (size_t probe = 0; probe <= max_probe; probe++)
+            {
+                uintptr_t current = entries[idx].key.load(std::memory_order_acquire);
+                if (current == key)
+                {
+                    return &entries[idx].value;
+                }
+                else if (current == EMPTY_KEY)
+                {
+                    return nullptr;
+                }
+
+                idx = (idx + 1) & (Capacity - 1);
+            }
+
+            return nullptr;
+        }
+
+        // Inserts the specified key, if it does not exist, and returns its value, or null if the table
+        // is full. The flag is set to true if the key was inserted by this call, in which case the
+        // caller must initialize the value.
+        Value* insert(uintptr_t key, bool& is_inserted) noexcept
+        {
+            is_inserted = false;
+            size_t idx = hash(key);
+            for (size_t probe = 0; probe < Capacity; probe++)
+            {
+                uintptr_t current = entries[idx].key.load(std::memory_order_acquire);
+                if (current == key)
+                {
+                    return &entries[idx].value;
+                }
+                else if (current == EMPTY_KEY || current == TOMBSTONE_KEY)
+                {
+                    // A tombstone is only reused if the key does not appear later in the probe sequence.
+                    if (current == EMPTY_KEY || find(key) == nullptr)
+                    {
+                        raise_max_probe_distance(probe);
+                        if (entries[idx].key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+                        {
+                            is_inserted = true;
+                            return &entries[idx].value;
+                        }
+                        else if (current == key)
+                        {
+                            return &entries[idx].value;
+                        }
+                    }
+                    else
+                    {
+                        return find(key);
+                    }
+                }
+
+                idx = (idx + 1) & (Capacity - 1);
+            }
+
+            return nullptr;
+        }
+
+        // Removes the specified key, if it exists.
+        void remove(uintptr_t key) noexcept
+        {
+            size_t idx = hash(key);
+            const size_t max_probe = max_probe_distance.load(std::memory_order_acquire);
+            for (size_t probe = 0; probe <= max_probe; probe++)
+            {
+                uintptr_t current = entries[idx].key.load(std::memory_order_acquire);
+                if (current == key)
+                {
+                    entries[idx].key.compare_exchange_strong(current, TOMBSTONE_KEY, std::memory_order_acq_rel);
+                    return;
+                }
+                else if (current == EMPTY_KEY)
+                {
+                    return;
+                }
+
+                idx = (idx + 1) & (Capacity - 1);
+            }
+        }
+
+    private:
+        // Raises the longest probe distance to the specified distance, if it is shorter.
+        void raise_max_probe_distance(size_t distance) noexcept
+        {
+            size_t current = max_probe_distance.load(std::memory_order_relaxed);
+            while (current < distance &&
+                !max_probe_distance.compare_exchange_weak(current, distance, std::memory_order_acq_rel))
+            {
+            }
+        }
+
+        static size_t hash(uintptr_t key) noexcept
+        {
+            // Fibonacci hashing spreads the aligned addresses across the table.
+            return (size_t)((key * UINT64_C(11400714819323198485)) >> 32) & (Capacity - 1);
+        }
+    };
+}
+
+#endif // COYOTE_ADDRESS_TABLE_H
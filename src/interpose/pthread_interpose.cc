@@ -0,0 +1,728 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+// Interposes the pthread, semaphore and yield functions of an unmodified Linux program when the library
+// is loaded through 'LD_PRELOAD', and maps them onto the operations and resources of a scheduler. Each
+// run of the program is one testing iteration, which is configured through environment variables:
+//
+//   COYOTE_STRATEGY        random (default), pct, pctcp, qlearning, portfolio or none
+//   COYOTE_SEED            the seed of the strategy, which defaults to the current time
+//   COYOTE_STRATEGY_BOUND  the bound of the strategy, such as the PCT priority switch bound
+//   COYOTE_MAX_STEPS       the max number of scheduling steps, which is unbounded by default
+//   COYOTE_MAX_TIME_MS     the max wall-clock duration in milliseconds, which is unbounded by default
+//   COYOTE_FAIR_STEPS      the number of fairly scheduled steps after a bound is exceeded
+//
+// If a deadlock or a potential livelock is detected, the library reports it with the seed to the
+// standard error and exits the program with the 'DeadlockDetected' or 'PotentialLivelockDetected'
+// error code.
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include "address_table.h"
+#include "scheduler.h"
+
+using namespace coyote;
+
+namespace
+{
+    // The operation id of threads that are not controlled by the scheduler.
+    constexpr size_t UNCONTROLLED_ID = SIZE_MAX;
+
+    // Operation id assigned to a thread, keyed by its pthread handle.
+    struct ThreadEntry
+    {
+        std::atomic<size_t> operation_id;
+    };
+
+    // Scheduler resource assigned to a mutex, condition variable or semaphore, keyed by its address.
+    struct ObjectEntry
+    {
+        std::atomic<size_t> resource_id;
+        std::atomic<size_t> waiting_count;
+    };
+
+    // The interposed functions of the next library in the lookup order.
+    struct RealFunctions
+    {
+        int (*pthread_create)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*);
+        int (*pthread_join)(pthread_t, void**);
+        int (*pthread_mutex_destroy)(pthread_mutex_t*);
+        int (*pthread_mutex_lock)(pthread_mutex_t*);
+        int (*pthread_mutex_trylock)(pthread_mutex_t*);
+        int (*pthread_mutex_timedlock)(pthread_mutex_t*, const struct timespec*);
+        int (*pthread_mutex_unlock)(pthread_mutex_t*);
+        int (*pthread_cond_destroy)(pthread_cond_t*);
+        int (*pthread_cond_wait)(pthread_cond_t*, pthread_mutex_t*);
+        int (*pthread_cond_timedwait)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+        int (*pthread_cond_signal)(pthread_cond_t*);
+        int (*pthread_cond_broadcast)(pthread_cond_t*);
+        int (*sem_destroy)(sem_t*);
+        int (*sem_wait)(sem_t*);
+        int (*sem_trywait)(sem_t*);
+        int (*sem_timedwait)(sem_t*, const struct timespec*);
+        int (*sem_post)(sem_t*);
+        int (*sched_yield)();
+    };
+
+    RealFunctions real;
+    std::atomic<bool> is_resolved(false);
+
+    // The scheduler, which is null until the library is initialized and after the program exits.
+    std::atomic<Scheduler*> scheduler(nullptr);
+
+    // Maps the pthread handles of controlled threads to their operation ids.
+    AddressTable<ThreadEntry, 4096> threads;
+
+    // Maps the addresses of synchronization objects to their resources.
+    AddressTable<ObjectEntry, 65536> objects;
+
+    // The next id assigned to a controlled thread.
+    std::atomic<size_t> next_operation_id(1);
+
+    // The operation id of the current thread. The initial-exec model avoids allocating on first access.
+    __thread size_t current_operation_id __attribute__((tls_model("initial-exec"))) = UNCONTROLLED_ID;
+
+    // True while the current thread executes inside the scheduler, whose own synchronization goes
+    // through the interposed functions and must reach the real ones.
+    __thread bool is_in_scheduler __attribute__((tls_model("initial-exec"))) = false;
+
+    template <typename Function>
+    void resolve(Function& function, const char* name, const char* version)
+    {
+        void* symbol = version != nullptr ? dlvsym(RTLD_NEXT, name, version) : nullptr;
+        if (symbol == nullptr)
+        {
+            symbol = dlsym(RTLD_NEXT, name);
+        }
+
+        function = reinterpret_cast<Function>(symbol);
+    }
+
+    // Resolves the real functions. Resolving is idempotent, so concurrent first calls are harmless.
+    void resolve_real_functions()
+    {
+        if (is_resolved.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        resolve(real.pthread_create, "pthread_create", nullptr);
+        resolve(real.pthread_join, "pthread_join", nullptr);
+        resolve(real.pthread_mutex_destroy, "pthread_mutex_destroy", nullptr);
+        resolve(real.pthread_mutex_lock, "pthread_mutex_lock", nullptr);
+        resolve(real.pthread_mutex_trylock, "pthread_mutex_trylock", nullptr);
+        resolve(real.pthread_mutex_timedlock, "pthread_mutex_timedlock", nullptr);
+        resolve(real.pthread_mutex_unlock, "pthread_mutex_unlock", nullptr);
+
+        // The default 'dlsym' lookup can return the legacy condition variable implementation.
+        resolve(real.pthread_cond_destroy, "pthread_cond_destroy", "GLIBC_2.3.2");
+        resolve(real.pthread_cond_wait, "pthread_cond_wait", "GLIBC_2.3.2");
+        resolve(real.pthread_cond_timedwait, "pthread_cond_timedwait", "GLIBC_2.3.2");
+        resolve(real.pthread_cond_signal, "pthread_cond_signal", "GLIBC_2.3.2");
+        resolve(real.pthread_cond_broadcast, "pthread_cond_broadcast", "GLIBC_2.3.2");
+
+        resolve(real.sem_destroy, "sem_destroy", nullptr);
+        resolve(real.sem_wait, "sem_wait", nullptr);
+        resolve(real.sem_trywait, "sem_trywait", nullptr);
+        resolve(real.sem_timedwait, "sem_timedwait", nullptr);
+        resolve(real.sem_post, "sem_post", nullptr);
+        resolve(real.sched_yield, "sched_yield", nullptr);
+        is_resolved.store(true, std::memory_order_release);
+    }
+
+    // Marks the current thread as executing inside the scheduler for the enclosing scope.
+    class SchedulerScope
+    {
+    public:
+        SchedulerScope() noexcept
+        {
+            is_in_scheduler = true;
+        }
+
+        ~SchedulerScope()
+        {
+            is_in_scheduler = false;
+        }
+    };
+
+    // Returns true if the current call must be controlled by the scheduler, else false.
+    bool is_controlled() noexcept
+    {
+        return !is_in_scheduler && current_operation_id != UNCONTROLLED_ID &&
+            scheduler.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Reports the specified bug and exits the program, as the threads that deadlocked or livelocked
+    // can never complete.
+    void report_bug(ErrorCode error_code)
+    {
+        Scheduler* s = scheduler.load(std::memory_order_acquire);
+        fprintf(stderr, "[coyote] %s detected in the schedule with seed %llu.\n",
+            error_code == ErrorCode::DeadlockDetected ? "deadlock" : "potential livelock",
+            s != nullptr ? (unsigned long long)s->random_seed() : 0ULL);
+        _exit(static_cast<int>(error_code));
+    }
+
+    // Invokes the specified scheduler API from the current thread. Returns true if the call succeeded,
+    // else false, in which case the caller must fall back to the real function.
+    template <typename Call>
+    bool invoke(Call call)
+    {
+        Scheduler* s = scheduler.load(std::memory_order_acquire);
+        if (s == nullptr)
+        {
+            return false;
+        }
+
+        ErrorCode error_code;
+        {
+            SchedulerScope scope;
+            error_code = call(s);
+        }
+
+        if (error_code == ErrorCode::DeadlockDetected || error_code == ErrorCode::PotentialLivelockDetected)
+        {
+            report_bug(error_code);
+        }
+
+        return error_code == ErrorCode::Success;
+    }
+
+    // Returns the resource of the specified synchronization object, creating it on first use, or null
+    // if the object cannot be tracked.
+    ObjectEntry* find_or_create_resource(const void* object)
+    {
+        bool is_inserted;
+        ObjectEntry* entry = objects.insert(reinterpret_cast<uintptr_t>(object), is_inserted);
+        if (entry != nullptr && is_inserted)
+        {
+            size_t resource_id = 0;
+            entry->waiting_count.store(0, std::memory_order_relaxed);
+            if (!invoke([&](Scheduler* s) { return s->create_unique_resource(resource_id); }))
+            {
+                objects.remove(reinterpret_cast<uintptr_t>(object));
+                return nullptr;
+            }
+
+            entry->resource_id.store(resource_id, std::memory_order_release);
+        }
+
+        return entry;
+    }
+
+    // Forgets the resource of the specified synchronization object.
+    void delete_resource(const void* object)
+    {
+        ObjectEntry* entry = objects.find(reinterpret_cast<uintptr_t>(object));
+        if (entry != nullptr)
+        {
+            size_t resource_id = entry->resource_id.load(std::memory_order_acquire);
+            objects.remove(reinterpret_cast<uintptr_t>(object));
+            invoke([&](Scheduler* s) { return s->delete_resource(resource_id); });
+        }
+    }
+
+    // Waits the resource of the specified object to be signaled. Returns false if the wait failed.
+    bool wait_resource(ObjectEntry* entry)
+    {
+        size_t resource_id = entry->resource_id.load(std::memory_order_acquire);
+        entry->waiting_count.fetch_add(1, std::memory_order_relaxed);
+        bool is_signaled = invoke([&](Scheduler* s) { return s->wait_resource(resource_id); });
+        entry->waiting_count.fetch_sub(1, std::memory_order_relaxed);
+        return is_signaled;
+    }
+
+    // Signals the operations waiting the resource of the specified object, if there are any.
+    void signal_resource(const void* object)
+    {
+        ObjectEntry* entry = objects.find(reinterpret_cast<uintptr_t>(object));
+        if (entry != nullptr && entry->waiting_count.load(std::memory_order_relaxed) > 0)
+        {
+            size_t resource_id = entry->resource_id.load(std::memory_order_acquire);
+            invoke([&](Scheduler* s) { return s->signal_resource(resource_id); });
+        }
+    }
+
+    void schedule_next()
+    {
+        invoke([](Scheduler* s) { return s->schedule_next(); });
+    }
+
+    int lock_mutex(pthread_mutex_t* mutex)
+    {
+        schedule_next();
+        int result = real.pthread_mutex_trylock(mutex);
+        if (result == EBUSY)
+        {
+            ObjectEntry* entry = find_or_create_resource(mutex);
+            while (result == EBUSY && entry != nullptr && wait_resource(entry))
+            {
+                result = real.pthread_mutex_trylock(mutex);
+            }
+
+            if (result == EBUSY)
+            {
+                // The scheduler stopped controlling the thread, so block on the real mutex.
+                result = real.pthread_mutex_lock(mutex);
+            }
+        }
+
+        return result;
+    }
+
+    int unlock_mutex(pthread_mutex_t* mutex)
+    {
+        int result = real.pthread_mutex_unlock(mutex);
+        if (result == 0)
+        {
+            signal_resource(mutex);
+        }
+
+        return result;
+    }
+
+    // Runs a controlled thread between starting and completing its operation.
+    struct ThreadStart
+    {
+        void* (*routine)(void*);
+        void* arg;
+        size_t operation_id;
+        std::atomic<int> state;
+    };
+
+    constexpr int THREAD_PENDING = 0;
+    constexpr int THREAD_CREATED = 1;
+    constexpr int THREAD_UNCONTROLLED = 2;
+
+    // Completes the operation of the current thread when its routine returns or the thread exits.
+    class OperationScope
+    {
+    public:
+        ~OperationScope()
+        {
+            size_t operation_id = current_operation_id;
+            invoke([&](Scheduler* s) { return s->complete_operation(operation_id); });
+            current_operation_id = UNCONTROLLED_ID;
+        }
+    };
+
+    void* run_thread(void* arg)
+    {
+        ThreadStart* start = static_cast<ThreadStart*>(arg);
+        void* (*routine)(void*) = start->routine;
+        void* routine_arg = start->arg;
+        size_t operation_id = start->operation_id;
+
+        // Wait until the creating thread has created the operation.
+        int state;
+        while ((state = start->state.load(std::memory_order_acquire)) == THREAD_PENDING)
+        {
+            real.sched_yield();
+        }
+
+        delete start;
+        if (state == THREAD_UNCONTROLLED)
+        {
+            return routine(routine_arg);
+        }
+
+        current_operation_id = operation_id;
+        if (!invoke([&](Scheduler* s) { return s->start_operation(operation_id); }))
+        {
+            current_operation_id = UNCONTROLLED_ID;
+            return routine(routine_arg);
+        }
+
+        OperationScope scope;
+        return routine(routine_arg);
+    }
+
+    Settings* create_settings()
+    {
+        Settings* settings = new Settings();
+        const char* strategy = getenv("COYOTE_STRATEGY");
+        const char* seed_value = getenv("COYOTE_SEED");
+        const char* bound_value = getenv("COYOTE_STRATEGY_BOUND");
+        uint64_t seed = seed_value != nullptr ? strtoull(seed_value, nullptr, 10) : settings->random_seed();
+        size_t bound = bound_value != nullptr ? (size_t)strtoull(bound_value, nullptr, 10) : 0;
+
+        if (strategy == nullptr || strcmp(strategy, "random") == 0)
+        {
+            settings->use_random_strategy(seed, bound_value != nullptr && bound <= 100 ? bound : 100);
+        }
+        else if (strcmp(strategy, "pct") == 0)
+        {
+            settings->use_pct_strategy(seed, bound_value != nullptr ? bound : 3);
+        }
+        else if (strcmp(strategy, "pctcp") == 0)
+        {
+            settings->use_pctcp_strategy(seed, bound_value != nullptr ? bound : 3);
+        }
+        else if (strcmp(strategy, "qlearning") == 0)
+        {
+            settings->use_qlearning_strategy(seed);
+        }
+        else if (strcmp(strategy, "portfolio") == 0)
+        {
+            settings->use_portfolio_strategy(seed);
+        }
+        else
+        {
+            settings->disable_scheduling();
+        }
+
+        const char* max_steps_value = getenv("COYOTE_MAX_STEPS");
+        const char* max_time_value = getenv("COYOTE_MAX_TIME_MS");
+        const char* fair_steps_value = getenv("COYOTE_FAIR_STEPS");
+        if (max_steps_value != nullptr)
+        {
+            settings->bound_iteration_steps((size_t)strtoull(max_steps_value, nullptr, 10));
+        }
+
+        if (max_time_value != nullptr)
+        {
+            settings->bound_iteration_time(std::chrono::milliseconds(strtoull(max_time_value, nullptr, 10)));
+        }
+
+        if (fair_steps_value != nullptr)
+        {
+            settings->use_fair_scheduling_suffix((size_t)strtoull(fair_steps_value, nullptr, 10));
+        }
+
+        return settings;
+    }
+
+    __attribute__((destructor))
+    void finalize()
+    {
+        Scheduler* s = scheduler.load(std::memory_order_acquire);
+        if (s != nullptr && current_operation_id == 0)
+        {
+            // Release any remaining controlled threads, which continue uncontrolled while the program exits.
+            invoke([](Scheduler* s) { return s->detach(); });
+            current_operation_id = UNCONTROLLED_ID;
+
+            // The scheduler is not deleted, as released threads can still be returning from it.
+            scheduler.store(nullptr, std::memory_order_release);
+        }
+    }
+
+    __attribute__((constructor))
+    void initialize()
+    {
+        resolve_real_functions();
+
+        Scheduler* s = new Scheduler(std::unique_ptr<Settings>(create_settings()));
+        if (!s->is_enabled())
+        {
+            delete s;
+            return;
+        }
+
+        // The thread that loads the library becomes the main operation.
+        scheduler.store(s, std::memory_order_release);
+        current_operation_id = 0;
+        if (!invoke([](Scheduler* s) { return s->attach(); }))
+        {
+            current_operation_id = UNCONTROLLED_ID;
+        }
+    }
+}
+
+extern "C"
+{
+    int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*routine)(void*), void* arg)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_create(thread, attr, routine, arg);
+        }
+
+        ThreadStart* start = new ThreadStart();
+        start->routine = routine;
+        start->arg = arg;
+        start->operation_id = next_operation_id.fetch_add(1, std::memory_order_relaxed);
+        start->state.store(THREAD_PENDING, std::memory_order_relaxed);
+
+        int result = real.pthread_create(thread, attr, run_thread, start);
+        if (result != 0)
+        {
+            delete start;
+            return result;
+        }
+
+        // The operation is created after the real thread, so that a failed creation does not leave an
+        // operation that never starts.
+        size_t operation_id = start->operation_id;
+        bool is_inserted;
+        ThreadEntry* entry = threads.insert((uintptr_t)*thread, is_inserted);
+        if (entry != nullptr && invoke([&](Scheduler* s) { return s->create_operation(operation_id); }))
+        {
+            entry->operation_id.store(operation_id, std::memory_order_release);
+            start->state.store(THREAD_CREATED, std::memory_order_release);
+        }
+        else
+        {
+            if (entry != nullptr)
+            {
+                threads.remove((uintptr_t)*thread);
+            }
+
+            start->state.store(THREAD_UNCONTROLLED, std::memory_order_release);
+        }
+
+        return 0;
+    }
+
+    int pthread_join(pthread_t thread, void** retval)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            ThreadEntry* entry = threads.find((uintptr_t)thread);
+            if (entry != nullptr)
+            {
+                size_t operation_id = entry->operation_id.load(std::memory_order_acquire);
+                invoke([&](Scheduler* s) { return s->join_operation(operation_id); });
+                threads.remove((uintptr_t)thread);
+            }
+        }
+
+        return real.pthread_join(thread, retval);
+    }
+
+    int pthread_mutex_destroy(pthread_mutex_t* mutex)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            delete_resource(mutex);
+        }
+
+        return real.pthread_mutex_destroy(mutex);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_mutex_lock(mutex);
+        }
+
+        return lock_mutex(mutex);
+    }
+
+    int pthread_mutex_trylock(pthread_mutex_t* mutex)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            schedule_next();
+        }
+
+        return real.pthread_mutex_trylock(mutex);
+    }
+
+    int pthread_mutex_timedlock(pthread_mutex_t* mutex, const struct timespec* abstime)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_mutex_timedlock(mutex, abstime);
+        }
+
+        // Time is not controlled, so the lock can time out whenever it is not available.
+        schedule_next();
+        int result = real.pthread_mutex_trylock(mutex);
+        return result == EBUSY ? ETIMEDOUT : result;
+    }
+
+    int pthread_mutex_unlock(pthread_mutex_t* mutex)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_mutex_unlock(mutex);
+        }
+
+        return unlock_mutex(mutex);
+    }
+
+    int pthread_cond_destroy(pthread_cond_t* cond)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            delete_resource(cond);
+        }
+
+        return real.pthread_cond_destroy(cond);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_cond_wait(cond, mutex);
+        }
+
+        ObjectEntry* entry = find_or_create_resource(cond);
+        if (entry == nullptr)
+        {
+            return real.pthread_cond_wait(cond, mutex);
+        }
+
+        // Waking up spuriously is allowed, so a failed wait returns after reacquiring the mutex.
+        unlock_mutex(mutex);
+        wait_resource(entry);
+        return lock_mutex(mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.pthread_cond_timedwait(cond, mutex, abstime);
+        }
+
+        // Time is not controlled, so the wait times out after giving the other threads a chance to run.
+        unlock_mutex(mutex);
+        schedule_next();
+        int result = lock_mutex(mutex);
+        return result == 0 ? ETIMEDOUT : result;
+    }
+
+    int pthread_cond_signal(pthread_cond_t* cond)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            // Waking up more than one waiter is allowed, and the waiters race for the mutex.
+            signal_resource(cond);
+        }
+
+        return real.pthread_cond_signal(cond);
+    }
+
+    int pthread_cond_broadcast(pthread_cond_t* cond)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            signal_resource(cond);
+        }
+
+        return real.pthread_cond_broadcast(cond);
+    }
+
+    int sem_destroy(sem_t* sem)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            delete_resource(sem);
+        }
+
+        return real.sem_destroy(sem);
+    }
+
+    int sem_wait(sem_t* sem)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.sem_wait(sem);
+        }
+
+        schedule_next();
+        int result = real.sem_trywait(sem);
+        bool is_unavailable = result != 0 && errno == EAGAIN;
+        if (is_unavailable)
+        {
+            ObjectEntry* entry = find_or_create_resource(sem);
+            while (is_unavailable && entry != nullptr && wait_resource(entry))
+            {
+                result = real.sem_trywait(sem);
+                is_unavailable = result != 0 && errno == EAGAIN;
+            }
+
+            if (is_unavailable)
+            {
+                // The scheduler stopped controlling the thread, so block on the real semaphore.
+                result = real.sem_wait(sem);
+            }
+        }
+
+        return result;
+    }
+
+    int sem_trywait(sem_t* sem)
+    {
+        resolve_real_functions();
+        if (is_controlled())
+        {
+            schedule_next();
+        }
+
+        return real.sem_trywait(sem);
+    }
+
+    int sem_timedwait(sem_t* sem, const struct timespec* abstime)
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.sem_timedwait(sem, abstime);
+        }
+
+        // Time is not controlled, so the wait can time out whenever no permit is available.
+        schedule_next();
+        int result = real.sem_trywait(sem);
+        if (result != 0 && errno == EAGAIN)
+        {
+            errno = ETIMEDOUT;
+        }
+
+        return result;
+    }
+
+    int sem_post(sem_t* sem)
+    {
+        resolve_real_functions();
+        int result = real.sem_post(sem);
+        if (result == 0 && is_controlled())
+        {
+            signal_resource(sem);
+        }
+
+        return result;
+    }
+
+    int sched_yield()
+    {
+        resolve_real_functions();
+        if (!is_controlled())
+        {
+            return real.sched_yield();
+        }
+
+        schedule_next();
+        return 0;
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto THREAD_COUNT = 4;
+constexpr auto RESOURCE_ID = 1;
+constexpr auto LOCK_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+Command command(CommandType type, size_t target_id, size_t argument = 0)
+{
+	return Command{ type, 0, target_id, argument };
+}
+
+void assert_success(const std::vector<ErrorCode>& error_codes)
+{
+	for (auto error_code : error_codes)
+	{
+		assert(error_code, ErrorCode::Success);
+	}
+}
+
+void work(size_t id)
+{
+	// Start the operation and acquire the lock in a single batch, which resumes once the operation is
+	// scheduled.
+	std::vector<Command> commands = {
+		command(CommandType::StartOperation, id),
+		command(CommandType::AcquireResource, LOCK_ID)
+	};
+
+	std::vector<ErrorCode> error_codes(commands.size());
+	scheduler->execute_batch(commands.data(), commands.size(), error_codes.data());
+	assert_success(error_codes);
+
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + 1;
+
+	// The batch stops once it completes the calling operation, which is no longer controlled.
+	commands = {
+		command(CommandType::ReleaseResource, LOCK_ID),
+		command(CommandType::SignalResource, RESOURCE_ID),
+		command(CommandType::CompleteOperation, id),
+		command(CommandType::ScheduleNext, 0)
+	};
+
+	error_codes.resize(commands.size());
+	scheduler->execute_batch(commands.data(), commands.size(), error_codes.data());
+	assert(error_codes[0], ErrorCode::Success);
+	assert(error_codes[1], ErrorCode::Success);
+	assert(error_codes[2], ErrorCode::Success);
+	assert(error_codes[3], ErrorCode::CommandNotExecuted);
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+	scheduler->attach();
+
+	// Create all operations and resources in a single batch.
+	std::vector<Command> commands;
+	for (size_t i = 1; i <= THREAD_COUNT; i++)
+	{
+		commands.push_back(command(CommandType::CreateOperationInGroup, i, i % 2));
+	}
+
+	commands.push_back(command(CommandType::CreateResource, RESOURCE_ID));
+	commands.push_back(command(CommandType::CreateResource, LOCK_ID, 1));
+
+	std::vector<ErrorCode> error_codes(commands.size());
+	assert(scheduler->execute_batch(commands.data(), commands.size(), error_codes.data()), ErrorCode::Success);
+	assert_success(error_codes);
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 1; i <= THREAD_COUNT; i++)
+	{
+		threads.push_back(std::make_unique<std::thread>(work, i));
+	}
+
+	commands.clear();
+	for (size_t i = 1; i <= THREAD_COUNT; i++)
+	{
+		commands.push_back(command(CommandType::JoinOperation, i));
+	}
+
+	error_codes.resize(commands.size());
+	scheduler->execute_batch(commands.data(), commands.size(), error_codes.data());
+	assert_success(error_codes);
+
+	for (auto& thread : threads)
+	{
+		thread->join();
+	}
+
+	assert(shared_var == THREAD_COUNT, "an update was lost while holding the lock.");
+
+	// The batch stops at the first command that fails, and the following commands are not executed.
+	commands = {
+		command(CommandType::DeleteResource, RESOURCE_ID),
+		command(CommandType::DeleteResource, RESOURCE_ID),
+		command(CommandType::CreateResource, RESOURCE_ID)
+	};
+
+	error_codes.resize(commands.size());
+	assert(scheduler->execute_batch(commands.data(), commands.size(), error_codes.data()),
+		ErrorCode::NotExistingResource);
+	assert(error_codes[0], ErrorCode::Success);
+	assert(error_codes[1], ErrorCode::NotExistingResource);
+	assert(error_codes[2], ErrorCode::CommandNotExecuted);
+
+	scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		scheduler->enable_latency_profiling();
+		for (int i = 0; i < 100; i++)
+		{
+			run_iteration();
+		}
+
+		assert(scheduler->latency_histogram(LatencyEvent::ExecuteBatch).count() == 100 * (3 + 2 * THREAD_COUNT),
+			"a batch was not recorded.");
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/trace/chrome_trace_writer.h"
+
+using namespace coyote;
+
+constexpr auto WORKER_COUNT = 2;
+constexpr auto RESOURCE_ID = 1;
+constexpr auto TRACE_FILE = "coyote_chrome_trace.json";
+
+Scheduler* scheduler;
+
+bool is_ready;
+
+void wait_ready(size_t id)
+{
+	scheduler->start_operation(id);
+	while (!is_ready)
+	{
+		scheduler->wait_resource(RESOURCE_ID);
+	}
+
+	scheduler->complete_operation(id);
+}
+
+void run_iteration()
+{
+	is_ready = false;
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		size_t id = i + 1;
+		scheduler->create_operation(id);
+		threads.push_back(std::make_unique<std::thread>(wait_ready, id));
+	}
+
+	scheduler->schedule_next();
+	is_ready = true;
+	scheduler->signal_resource(RESOURCE_ID);
+
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		scheduler->join_operation(i + 1);
+		threads[i]->join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+size_t count_occurrences(const std::string& text, const std::string& pattern)
+{
+	size_t count = 0;
+	for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		scheduler->set_trace_sink(std::make_unique<ChromeTraceWriter>(TRACE_FILE));
+		run_iteration();
+		run_iteration();
+
+		// Closes the trace file.
+		scheduler->set_trace_sink(nullptr);
+		delete scheduler;
+
+		std::ifstream file(TRACE_FILE);
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		std::string trace = buffer.str();
+		file.close();
+		std::remove(TRACE_FILE);
+
+		assert(trace.front() == '[' && trace.find_last_of(']') != std::string::npos, "trace is not a JSON array");
+		assert(count_occurrences(trace, "\"name\":\"iteration ") == 2, "unexpected number of iterations");
+		assert(count_occurrences(trace, "\"ph\":\"B\"") == count_occurrences(trace, "\"ph\":\"E\""),
+			"unbalanced spans");
+		assert(count_occurrences(trace, "\"ph\":\"s\"") == count_occurrences(trace, "\"ph\":\"f\""),
+			"unbalanced flow arrows");
+		assert(count_occurrences(trace, "\"name\":\"complete operation ") >= 2, "missing join flow arrows");
+		assert(count_occurrences(trace, "\"name\":\"operation 2\"") == 2, "missing operation track");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
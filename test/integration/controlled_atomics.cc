@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/sync/atomic.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+coyote::atomic<int>* counter;
+
+// Increments the counter with a separate load and store, which can lose an update.
+void racy_increment(std::memory_order order)
+{
+	int value = counter->load(order);
+	counter->store(value + 1, order);
+}
+
+// Returns the number of iterations in which an update was lost.
+int run_iterations(int iterations, bool is_atomic, std::memory_order order)
+{
+	int lost_updates = 0;
+	for (int i = 0; i < iterations; i++)
+	{
+		scheduler->attach();
+		coyote::atomic<int> value(scheduler, 0);
+		counter = &value;
+
+		auto work = [is_atomic, order](int id)
+		{
+			scheduler->start_operation(id);
+			if (is_atomic)
+			{
+				counter->fetch_add(1, order);
+			}
+			else
+			{
+				racy_increment(order);
+			}
+
+			scheduler->complete_operation(id);
+		};
+
+		scheduler->create_operation(WORK_THREAD_1_ID);
+		std::thread t1(work, WORK_THREAD_1_ID);
+		scheduler->create_operation(WORK_THREAD_2_ID);
+		std::thread t2(work, WORK_THREAD_2_ID);
+
+		scheduler->join_operation(WORK_THREAD_1_ID);
+		scheduler->join_operation(WORK_THREAD_2_ID);
+		t1.join();
+		t2.join();
+
+		if (value.load() != 2)
+		{
+			lost_updates++;
+		}
+
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+
+	return lost_updates;
+}
+
+Scheduler* create_scheduler(AtomicDensity density, size_t probability)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_random_strategy(7);
+	if (density == AtomicDensity::Sampled)
+	{
+		settings->use_sampled_atomic_density(probability);
+	}
+	else
+	{
+		settings->use_atomic_density(density);
+	}
+
+	return new Scheduler(std::move(settings));
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		// Every access is a scheduling point, so the lost update is found.
+		scheduler = create_scheduler(AtomicDensity::EveryAccess, 100);
+		assert(run_iterations(100, false, std::memory_order_relaxed) > 0, "the lost update was not found.");
+		assert(run_iterations(100, true, std::memory_order_relaxed) == 0, "an atomic increment lost an update.");
+		delete scheduler;
+
+		// Relaxed loads and stores are not scheduling points, so the operations run one after the other.
+		scheduler = create_scheduler(AtomicDensity::Synchronizing, 100);
+		assert(run_iterations(100, false, std::memory_order_relaxed) == 0, "a relaxed access was a scheduling point.");
+		assert(run_iterations(100, false, std::memory_order_seq_cst) > 0, "the lost update was not found.");
+		delete scheduler;
+
+		// No access is sampled as a scheduling point.
+		scheduler = create_scheduler(AtomicDensity::Sampled, 0);
+		assert(run_iterations(100, false, std::memory_order_seq_cst) == 0, "an access was sampled.");
+		delete scheduler;
+
+		scheduler = create_scheduler(AtomicDensity::Sampled, 50);
+		assert(run_iterations(100, false, std::memory_order_seq_cst) > 0, "the lost update was not found.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
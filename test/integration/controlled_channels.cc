@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/sync/channel.h"
+#include "coyote/sync/thread.h"
+
+using namespace coyote;
+
+constexpr auto MESSAGE_COUNT = 5;
+
+Scheduler* scheduler;
+
+// Sends messages from two producers to two consumers through a channel with the specified capacity,
+// and checks that each message is received exactly once.
+void test_producers_consumers(size_t capacity)
+{
+	scheduler->attach();
+	{
+		channel<int> messages(scheduler, capacity);
+		int received_sum[2] = { 0, 0 };
+
+		auto produce = [&messages](int offset)
+		{
+			for (int i = 1; i <= MESSAGE_COUNT; i++)
+			{
+				assert(messages.send(offset + i), "the channel was closed while sending.");
+			}
+		};
+
+		auto consume = [&messages, &received_sum](int index)
+		{
+			int message;
+			while (messages.receive(message))
+			{
+				received_sum[index] += message;
+			}
+		};
+
+		coyote::thread producer_1(scheduler, produce, 0);
+		coyote::thread producer_2(scheduler, produce, 100);
+		coyote::thread consumer_1(scheduler, consume, 0);
+		coyote::thread consumer_2(scheduler, consume, 1);
+
+		producer_1.join();
+		producer_2.join();
+		messages.close();
+		assert(!messages.try_send(0), "a message was sent to a closed channel.");
+		consumer_1.join();
+		consumer_2.join();
+
+		int expected_sum = 2 * (MESSAGE_COUNT * (MESSAGE_COUNT + 1) / 2) + 100 * MESSAGE_COUNT;
+		assert(received_sum[0] + received_sum[1] == expected_sum, "a message was lost or duplicated.");
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+// Sends two messages and returns true if they were received out of order.
+bool test_delivery_order(bool reorder_deliveries)
+{
+	int first = 0;
+	scheduler->attach();
+	{
+		channel<int> messages(scheduler, channel<int>::unbounded, reorder_deliveries);
+		messages.send(1);
+		messages.send(2);
+
+		int second = 0;
+		assert(messages.receive(first) && messages.receive(second), "a message was not received.");
+		assert(!messages.try_receive(second), "a message was received from an empty channel.");
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return first == 2;
+}
+
+// Receives from a channel that nothing sends to, which must be reported as a deadlock.
+void test_receive_deadlock()
+{
+	scheduler->attach();
+	{
+		channel<int> messages(scheduler);
+		int message;
+		assert(!messages.receive(message), "a message was received from an empty channel.");
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::DeadlockDetected);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		int reordered_count = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			test_producers_consumers(1);
+			test_producers_consumers(channel<int>::unbounded);
+			assert(!test_delivery_order(false), "the messages were received out of order.");
+			reordered_count += test_delivery_order(true) ? 1 : 0;
+			test_receive_deadlock();
+		}
+
+		assert(reordered_count > 0, "the messages were never reordered.");
+		delete scheduler;
+
+		// If scheduling is disabled, the channel is a native blocking queue.
+		auto settings = std::make_unique<Settings>();
+		settings->disable_scheduling();
+		scheduler = new Scheduler(std::move(settings));
+		{
+			channel<int> messages(scheduler, 1);
+			coyote::thread producer(scheduler, [&messages]()
+			{
+				for (int i = 1; i <= MESSAGE_COUNT; i++)
+				{
+					messages.send(i);
+				}
+
+				messages.close();
+			});
+
+			int message, sum = 0;
+			while (messages.receive(message))
+			{
+				sum += message;
+			}
+
+			producer.join();
+			assert(sum == MESSAGE_COUNT * (MESSAGE_COUNT + 1) / 2, "a native message was lost.");
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/sync/mutex.h"
+#include "coyote/sync/thread.h"
+
+using namespace coyote;
+
+constexpr auto THREAD_COUNT = 3;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+// Increments the shared variable with a separate read and write, which can lose an update.
+void racy_increment(int delta)
+{
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + delta;
+}
+
+// Runs the racy increments on controlled threads, and returns true if an update was lost.
+bool run_iteration(thread_pool* pool)
+{
+	shared_var = 0;
+	scheduler->attach();
+
+	std::vector<coyote::thread> threads;
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		if (pool != nullptr)
+		{
+			threads.emplace_back(*pool, racy_increment, 1);
+		}
+		else
+		{
+			threads.emplace_back(scheduler, racy_increment, 1);
+		}
+
+		assert(threads.back().operation_id() == (size_t)i + 1, "the operation id is not dense.");
+	}
+
+	for (auto& t : threads)
+	{
+		t.join();
+		assert(!t.joinable(), "the thread is joinable after joining it.");
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return shared_var != THREAD_COUNT;
+}
+
+// Runs a thread that creates a nested thread, which synchronize through a controlled mutex.
+void run_nested_iteration(thread_pool& pool)
+{
+	shared_var = 0;
+	scheduler->attach();
+	{
+		coyote::mutex mutex(scheduler);
+		coyote::thread parent(pool, [&pool, &mutex]()
+		{
+			coyote::thread child(pool, [&mutex]()
+			{
+				std::lock_guard<coyote::mutex> lock(mutex);
+				shared_var++;
+			});
+
+			{
+				std::lock_guard<coyote::mutex> lock(mutex);
+				shared_var++;
+			}
+
+			child.join();
+		});
+
+		parent.join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(shared_var == 2, "an update was lost.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		int lost_updates = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			lost_updates += run_iteration(nullptr) ? 1 : 0;
+		}
+
+		assert(lost_updates > 0, "the lost update was not found on native threads.");
+
+		{
+			thread_pool pool(scheduler);
+			lost_updates = 0;
+			for (int i = 0; i < 100; i++)
+			{
+				lost_updates += run_iteration(&pool) ? 1 : 0;
+				run_nested_iteration(pool);
+			}
+
+			assert(lost_updates > 0, "the lost update was not found on pooled threads.");
+			assert(pool.size() <= THREAD_COUNT, "the pool did not recycle its threads.");
+		}
+
+		delete scheduler;
+
+		// If scheduling is disabled, the threads run natively.
+		auto settings = std::make_unique<Settings>();
+		settings->disable_scheduling();
+		scheduler = new Scheduler(std::move(settings));
+		coyote::thread t(scheduler, [](int value) { shared_var = value; }, 7);
+		assert(t.operation_id() == 0, "a thread has an operation while scheduling is disabled.");
+		t.join();
+		assert(shared_var == 7, "the native thread did not run.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
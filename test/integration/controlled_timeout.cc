@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+
+Scheduler* scheduler;
+
+bool is_signaled;
+bool is_signal_sent;
+
+// Runs an operation that waits the resource with a controlled timeout, and another operation that
+// signals the resource, if 'is_signal_sent' is true.
+void run_iteration()
+{
+	is_signaled = false;
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1([]()
+	{
+		scheduler->start_operation(WORK_THREAD_1_ID);
+		scheduler->wait_resource_for(RESOURCE_ID, is_signaled);
+		scheduler->complete_operation(WORK_THREAD_1_ID);
+	});
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2([]()
+	{
+		scheduler->start_operation(WORK_THREAD_2_ID);
+		if (is_signal_sent)
+		{
+			scheduler->signal_resource(RESOURCE_ID);
+		}
+
+		scheduler->complete_operation(WORK_THREAD_2_ID);
+	});
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(scheduler->virtual_time() == std::chrono::nanoseconds(0), "the timeout advanced the virtual time.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		// The strategy decides whether the signal or the timeout happens first, so both are explored.
+		int signaled_count = 0;
+		is_signal_sent = true;
+		for (int i = 0; i < 100; i++)
+		{
+			run_iteration();
+			if (is_signaled)
+			{
+				signaled_count++;
+			}
+		}
+
+		assert(signaled_count > 0, "the wait was never signaled.");
+		assert(signaled_count < 100, "the wait never timed out.");
+
+		// Without a signal, the wait always times out instead of deadlocking.
+		is_signal_sent = false;
+		for (int i = 0; i < 100; i++)
+		{
+			run_iteration();
+			assert(!is_signaled, "the wait was signaled without a signal.");
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
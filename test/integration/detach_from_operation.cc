@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_ID = 1;
+
+Scheduler* scheduler;
+
+// Detaches the client from inside an operation, while the main operation is paused joining it.
+void work()
+{
+	scheduler->start_operation(WORK_THREAD_ID);
+	scheduler->schedule_next();
+	scheduler->detach();
+}
+
+void run_iteration()
+{
+	assert(scheduler->attach(), ErrorCode::Success);
+	scheduler->create_operation(WORK_THREAD_ID);
+	std::thread t(work);
+
+	// The main operation is paused until the work operation completes, which it never does, so the
+	// detach must release the main operation as well.
+	ErrorCode error_code = scheduler->join_operation(WORK_THREAD_ID);
+	t.join();
+
+	assert(error_code, ErrorCode::ClientNotAttached);
+	assert(scheduler->detach(), ErrorCode::ClientNotAttached);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		for (int i = 0; i < 100; i++)
+		{
+			run_iteration();
+		}
+
+		assert(scheduler->total_statistics().iterations == 100, "an iteration was not explored.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORKER_COUNT = 3;
+constexpr auto ITERATIONS = 10;
+
+Scheduler* scheduler;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	scheduler->schedule_next();
+	scheduler->complete_operation(id);
+}
+
+void run_iteration()
+{
+	scheduler->attach();
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		size_t id = i + 1;
+		scheduler->create_operation(id);
+		threads.push_back(std::make_unique<std::thread>(work, id));
+	}
+
+	scheduler->schedule_next();
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		scheduler->join_operation(i + 1);
+		threads[i]->join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+
+	ExplorationStatistics statistics = scheduler->iteration_statistics();
+	assert(statistics.iterations == 1, "unexpected iteration count");
+	assert(statistics.deadlocks == 0, "unexpected deadlock count");
+	assert(statistics.steps >= WORKER_COUNT * 2, "unexpected step count");
+	assert(statistics.context_switches <= statistics.steps, "unexpected context switch count");
+	assert(statistics.max_concurrent_operations == WORKER_COUNT + 1, "unexpected max concurrent operations");
+	assert(statistics.max_enabled_operations >= 2 && statistics.max_enabled_operations <= WORKER_COUNT + 1,
+		"unexpected max enabled operations");
+}
+
+void run_deadlock_iteration()
+{
+	scheduler->attach();
+	scheduler->create_resource(1);
+	scheduler->wait_resource(1);
+	assert(scheduler->error_code(), ErrorCode::DeadlockDetected);
+	scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		size_t total_steps = 0;
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			run_iteration();
+			total_steps += scheduler->iteration_statistics().steps;
+		}
+
+		run_deadlock_iteration();
+		assert(scheduler->iteration_statistics().deadlocks == 1, "unexpected deadlock count");
+
+		ExplorationStatistics statistics = scheduler->total_statistics();
+		assert(statistics.iterations == ITERATIONS + 1, "unexpected total iteration count");
+		assert(statistics.steps == total_steps, "unexpected total step count");
+		assert(statistics.deadlocks == 1, "unexpected total deadlock count");
+		assert(statistics.max_concurrent_operations == WORKER_COUNT + 1, "unexpected total max concurrent operations");
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
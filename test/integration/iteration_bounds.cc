@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_ID = 1;
+constexpr auto MAX_STEPS = 1000;
+
+Scheduler* scheduler;
+
+// Spins for the specified number of scheduling steps, or forever if zero, like a retry loop.
+void spin(size_t iterations)
+{
+	scheduler->start_operation(WORK_THREAD_ID);
+	for (size_t i = 0; iterations == 0 || i < iterations; i++)
+	{
+		if (scheduler->schedule_next() != ErrorCode::Success)
+		{
+			// The iteration ended, so the operation is no longer controlled.
+			return;
+		}
+	}
+
+	scheduler->complete_operation(WORK_THREAD_ID);
+}
+
+// Runs an operation that spins for the specified number of steps, and returns the error code of the iteration.
+ErrorCode run_iteration(size_t iterations)
+{
+	scheduler->attach();
+	scheduler->create_operation(WORK_THREAD_ID);
+	std::thread t(spin, iterations);
+
+	scheduler->join_operation(WORK_THREAD_ID);
+	t.join();
+	return scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		for (int i = 0; i < 10; i++)
+		{
+			// Without bounds, a long spin completes.
+			scheduler->set_iteration_bounds(0, std::chrono::milliseconds(0), 0);
+			assert(run_iteration(2 * MAX_STEPS), ErrorCode::Success);
+
+			// A spin that exceeds the step bound is a potential livelock, which releases all operations.
+			scheduler->set_iteration_bounds(MAX_STEPS, std::chrono::milliseconds(0), 0);
+			assert(run_iteration(0), ErrorCode::PotentialLivelockDetected);
+			assert(scheduler->iteration_statistics().steps == MAX_STEPS, "the step bound was not enforced.");
+			assert(run_iteration(2 * MAX_STEPS), ErrorCode::PotentialLivelockDetected);
+
+			// A spin that completes during the fair steps only ran long, whereas an endless spin does not.
+			scheduler->set_iteration_bounds(MAX_STEPS, std::chrono::milliseconds(0), 2 * MAX_STEPS);
+			assert(run_iteration(2 * MAX_STEPS), ErrorCode::Success);
+			assert(run_iteration(0), ErrorCode::PotentialLivelockDetected);
+			assert(scheduler->iteration_statistics().steps == 3 * MAX_STEPS, "the fair steps were not bounded.");
+		}
+
+		// A spin that exceeds the time bound is also a potential livelock.
+		scheduler->set_iteration_bounds(0, std::chrono::milliseconds(20), 0);
+		auto iteration_start_time = std::chrono::steady_clock::now();
+		assert(run_iteration(0), ErrorCode::PotentialLivelockDetected);
+		assert(std::chrono::steady_clock::now() - iteration_start_time >= std::chrono::milliseconds(20),
+			"the time bound was exceeded too early.");
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
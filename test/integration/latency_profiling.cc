@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <climits>
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORKER_COUNT = 4;
+constexpr auto ITERATIONS = 20;
+constexpr auto RESOURCE_ID = 1;
+
+Scheduler* scheduler;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	scheduler->schedule_next();
+	scheduler->signal_resource(RESOURCE_ID);
+	scheduler->complete_operation(id);
+}
+
+void run_iteration()
+{
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		size_t id = i + 1;
+		scheduler->create_operation(id);
+		threads.push_back(std::make_unique<std::thread>(work, id));
+	}
+
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		scheduler->join_operation(i + 1);
+		threads[i]->join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		assert(scheduler->latency_histogram(LatencyEvent::Attach).count() == 0, "unexpected latency without profiling");
+
+		scheduler->enable_latency_profiling();
+		assert(scheduler->is_latency_profiling_enabled(), "latency profiling is not enabled");
+
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			run_iteration();
+		}
+
+		assert(scheduler->latency_histogram(LatencyEvent::Attach).count() == ITERATIONS, "unexpected attach count");
+		assert(scheduler->latency_histogram(LatencyEvent::Detach).count() == ITERATIONS, "unexpected detach count");
+		assert(scheduler->latency_histogram(LatencyEvent::CreateOperation).count() == ITERATIONS * WORKER_COUNT,
+			"unexpected create operation count");
+		assert(scheduler->latency_histogram(LatencyEvent::StartOperation).count() == ITERATIONS * WORKER_COUNT,
+			"unexpected start operation count");
+		assert(scheduler->latency_histogram(LatencyEvent::CompleteOperation).count() == ITERATIONS * WORKER_COUNT,
+			"unexpected complete operation count");
+		assert(scheduler->latency_histogram(LatencyEvent::SignalResource).count() == ITERATIONS * WORKER_COUNT,
+			"unexpected signal resource count");
+
+		// Each worker must be handed the execution at least once.
+		const LatencyHistogram& handoffs = scheduler->latency_histogram(LatencyEvent::Handoff);
+		assert(handoffs.count() >= ITERATIONS * WORKER_COUNT, "unexpected handoff count");
+		assert(handoffs.percentile(50) <= handoffs.max(), "unexpected handoff median");
+
+		// Events that a host passes as out of range integers have no latencies.
+		for (int event : { -1, (int)LatencyProfile::EVENT_COUNT, INT_MAX })
+		{
+			const LatencyHistogram& histogram = scheduler->latency_histogram(static_cast<LatencyEvent>(event));
+			assert(histogram.count() == 0 && histogram.max() == 0, "unexpected latency of an invalid event");
+		}
+
+		scheduler->clear_latency_histograms();
+		assert(scheduler->latency_histogram(LatencyEvent::Handoff).count() == 0, "unexpected handoff count after clear");
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
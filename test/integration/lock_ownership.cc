@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_ID = 1;
+constexpr auto LOCK_ID = 1;
+
+Scheduler* scheduler;
+
+// Releases a lock that the main operation never acquired.
+void release_unheld_lock()
+{
+	assert(scheduler->attach(), ErrorCode::Success);
+	assert(scheduler->create_lock(LOCK_ID), ErrorCode::Success);
+	assert(scheduler->release_resource(LOCK_ID), ErrorCode::ResourceNotHeld);
+	assert(scheduler->detach(), ErrorCode::ResourceNotHeld);
+}
+
+// Releases a lock twice after acquiring it once.
+void release_lock_twice()
+{
+	assert(scheduler->attach(), ErrorCode::Success);
+	assert(scheduler->create_lock(LOCK_ID), ErrorCode::Success);
+	assert(scheduler->acquire_resource(LOCK_ID), ErrorCode::Success);
+	assert(scheduler->release_resource(LOCK_ID), ErrorCode::Success);
+	assert(scheduler->release_resource(LOCK_ID), ErrorCode::ResourceNotHeld);
+	assert(scheduler->detach(), ErrorCode::ResourceNotHeld);
+}
+
+// Releases a lock that another operation holds.
+void release_lock_of_other_operation()
+{
+	assert(scheduler->attach(), ErrorCode::Success);
+	assert(scheduler->create_lock(LOCK_ID), ErrorCode::Success);
+	assert(scheduler->create_operation(WORK_THREAD_ID), ErrorCode::Success);
+
+	// The operations only run one at a time, so these are only accessed by the scheduled operation.
+	bool is_acquired = false;
+	bool is_release_attempted = false;
+	std::thread t([&is_acquired, &is_release_attempted]()
+	{
+		scheduler->start_operation(WORK_THREAD_ID);
+		scheduler->acquire_resource(LOCK_ID);
+		is_acquired = true;
+		while (!is_release_attempted)
+		{
+			scheduler->schedule_next();
+		}
+
+		scheduler->release_resource(LOCK_ID);
+		scheduler->complete_operation(WORK_THREAD_ID);
+	});
+
+	while (!is_acquired)
+	{
+		assert(scheduler->schedule_next(), ErrorCode::Success);
+	}
+
+	ErrorCode error_code = scheduler->release_resource(LOCK_ID);
+	is_release_attempted = true;
+	scheduler->join_operation(WORK_THREAD_ID);
+	t.join();
+
+	assert(error_code, ErrorCode::ResourceNotHeld);
+	assert(scheduler->detach(), ErrorCode::ResourceNotHeld);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		for (int i = 0; i < 10; i++)
+		{
+			release_unheld_lock();
+			release_lock_twice();
+			release_lock_of_other_operation();
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
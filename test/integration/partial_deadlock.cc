@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto BACKGROUND_THREAD_ID = 3;
+constexpr auto LOCK_A_ID = 1;
+constexpr auto LOCK_B_ID = 2;
+
+Scheduler* scheduler;
+
+int completed_workers;
+
+// Acquires both locks in the specified order.
+void lock_in_order(size_t id, size_t first_lock_id, size_t second_lock_id)
+{
+	scheduler->start_operation(id);
+	if (scheduler->acquire_resource(first_lock_id) != ErrorCode::Success ||
+		scheduler->acquire_resource(second_lock_id) != ErrorCode::Success)
+	{
+		// The iteration ended with a deadlock, so the operation is no longer controlled.
+		return;
+	}
+
+	scheduler->release_resource(second_lock_id);
+	scheduler->release_resource(first_lock_id);
+	completed_workers++;
+	scheduler->complete_operation(id);
+}
+
+// Joins the operation with the specified id.
+void join(size_t id, size_t join_id)
+{
+	scheduler->start_operation(id);
+	if (scheduler->join_operation(join_id) != ErrorCode::Success)
+	{
+		return;
+	}
+
+	completed_workers++;
+	scheduler->complete_operation(id);
+}
+
+// Keeps running until both workers complete, so the scheduler never runs out of enabled operations.
+void run_background_loop()
+{
+	scheduler->start_operation(BACKGROUND_THREAD_ID);
+	while (completed_workers < 2)
+	{
+		if (scheduler->schedule_next() != ErrorCode::Success)
+		{
+			return;
+		}
+	}
+
+	scheduler->complete_operation(BACKGROUND_THREAD_ID);
+}
+
+// Runs two workers next to a background loop, and returns the cycle of the detected deadlock, if any.
+std::vector<WaitForEdge> run_iteration(bool use_locks)
+{
+	completed_workers = 0;
+	scheduler->attach();
+	scheduler->create_lock(LOCK_A_ID);
+	scheduler->create_lock(LOCK_B_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	scheduler->create_operation(BACKGROUND_THREAD_ID);
+
+	std::thread t1, t2;
+	if (use_locks)
+	{
+		t1 = std::thread(lock_in_order, WORK_THREAD_1_ID, LOCK_A_ID, LOCK_B_ID);
+		t2 = std::thread(lock_in_order, WORK_THREAD_2_ID, LOCK_B_ID, LOCK_A_ID);
+	}
+	else
+	{
+		t1 = std::thread(join, WORK_THREAD_1_ID, WORK_THREAD_2_ID);
+		t2 = std::thread(join, WORK_THREAD_2_ID, WORK_THREAD_1_ID);
+	}
+
+	std::thread background(run_background_loop);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	scheduler->join_operation(BACKGROUND_THREAD_ID);
+	t1.join();
+	t2.join();
+	background.join();
+
+	std::vector<WaitForEdge> cycle = scheduler->deadlock_cycle();
+	ErrorCode error_code = scheduler->detach();
+	assert(error_code, cycle.empty() ? ErrorCode::Success : ErrorCode::DeadlockDetected);
+	return cycle;
+}
+
+// Checks that the specified cycle consists of the two workers waiting for each other.
+void check_cycle(const std::vector<WaitForEdge>& cycle, bool is_joining)
+{
+	assert(cycle.size() == 2, "the deadlock cycle does not consist of the two workers.");
+	for (size_t i = 0; i < cycle.size(); i++)
+	{
+		const WaitForEdge& edge = cycle[i];
+		const WaitForEdge& next_edge = cycle[(i + 1) % cycle.size()];
+		assert(edge.target_operation_id == next_edge.operation_id, "the deadlock cycle is not closed.");
+		assert(edge.operation_id != BACKGROUND_THREAD_ID, "the background operation is in the deadlock cycle.");
+		assert(edge.is_joining == is_joining, "the deadlock cycle has an unexpected wait.");
+		if (!is_joining)
+		{
+			// Each worker waits for the lock that the other worker acquired first.
+			size_t expected_lock_id = edge.operation_id == WORK_THREAD_1_ID ? LOCK_B_ID : LOCK_A_ID;
+			assert(edge.resource_id == expected_lock_id, "the deadlock cycle has an unexpected lock.");
+		}
+	}
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		// Each worker joins the other, which is always a deadlock.
+		for (int i = 0; i < 10; i++)
+		{
+			check_cycle(run_iteration(false), true);
+		}
+
+		// The workers acquire the locks in opposite orders, which is a deadlock in some schedules only.
+		int deadlocks = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			std::vector<WaitForEdge> cycle = run_iteration(true);
+			if (!cycle.empty())
+			{
+				check_cycle(cycle, false);
+				deadlocks++;
+			}
+		}
+
+		assert(deadlocks > 0, "the deadlock was not found.");
+		assert(scheduler->total_statistics().deadlocks == (size_t)deadlocks + 10, "a deadlock was not counted.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
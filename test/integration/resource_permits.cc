@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto THREAD_COUNT = 6;
+constexpr auto SEMAPHORE_ID = 1;
+constexpr auto MAX_ALLOWED = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+int max_value_observed;
+int current_acquired;
+
+// Enters the semaphore by waiting for signals until a permit is counted as available. Entering is a
+// scheduling point, as acquiring a permit is.
+void enter_signaled_semaphore()
+{
+	scheduler->schedule_next();
+	while (current_acquired == MAX_ALLOWED)
+	{
+		scheduler->wait_resource(SEMAPHORE_ID);
+	}
+
+	current_acquired++;
+}
+
+// Exits the semaphore by signaling all waiting operations.
+void exit_signaled_semaphore()
+{
+	current_acquired--;
+	scheduler->signal_resource(SEMAPHORE_ID);
+}
+
+void work(int id, bool use_permits)
+{
+	scheduler->start_operation(id);
+	if (use_permits)
+	{
+		scheduler->acquire_resource(SEMAPHORE_ID);
+	}
+	else
+	{
+		enter_signaled_semaphore();
+	}
+
+	shared_var++;
+	if (shared_var > max_value_observed)
+	{
+		max_value_observed = shared_var;
+	}
+
+	scheduler->schedule_next();
+	shared_var--;
+
+	if (use_permits)
+	{
+		scheduler->release_resource(SEMAPHORE_ID);
+	}
+	else
+	{
+		exit_signaled_semaphore();
+	}
+
+	scheduler->complete_operation(id);
+}
+
+// Runs the operations that enter the semaphore, and returns the number of scheduling steps.
+size_t run_iteration(bool use_permits)
+{
+	shared_var = 0;
+	max_value_observed = 0;
+	current_acquired = 0;
+
+	scheduler->attach();
+	scheduler->create_resource(SEMAPHORE_ID, use_permits ? MAX_ALLOWED : 0);
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		int thread_id = i + 1;
+		scheduler->create_operation(thread_id);
+		threads.push_back(std::make_unique<std::thread>(work, thread_id, use_permits));
+	}
+
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		scheduler->join_operation(i + 1);
+		threads[i]->join();
+	}
+
+	size_t steps = scheduler->iteration_statistics().steps;
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(max_value_observed <= MAX_ALLOWED, "the observed max value is greater than allowed");
+	return steps;
+}
+
+void test_try_acquire()
+{
+	scheduler->attach();
+	scheduler->create_resource(SEMAPHORE_ID, 1);
+
+	bool is_acquired = false;
+	scheduler->try_acquire_resource(SEMAPHORE_ID, is_acquired);
+	assert(is_acquired, "the available permit was not acquired.");
+	scheduler->try_acquire_resource(SEMAPHORE_ID, is_acquired);
+	assert(!is_acquired, "a permit was acquired although none is available.");
+
+	// Nothing releases the permit, so the timed acquire times out in virtual time.
+	scheduler->acquire_resource_for(SEMAPHORE_ID, std::chrono::milliseconds(10), is_acquired);
+	assert(!is_acquired, "a permit was acquired although none is available.");
+	assert(scheduler->virtual_time() == std::chrono::milliseconds(10), "the acquire did not time out.");
+
+	scheduler->release_resource(SEMAPHORE_ID);
+	scheduler->acquire_resource_for(SEMAPHORE_ID, std::chrono::milliseconds(10), is_acquired);
+	assert(is_acquired, "the released permit was not acquired.");
+
+	// Acquiring a permit that is never released is a deadlock.
+	assert(scheduler->acquire_resource(SEMAPHORE_ID), ErrorCode::DeadlockDetected);
+	scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		size_t signaled_steps = 0;
+		size_t permit_steps = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			signaled_steps += run_iteration(false);
+			permit_steps += run_iteration(true);
+			test_try_acquire();
+		}
+
+		// Releasing a permit only enables the operation that receives it, so no operation wakes up only
+		// to block again.
+		std::cout << "[test] steps with signals: " << signaled_steps << ", with permits: " << permit_steps << std::endl;
+		assert(permit_steps < signaled_steps, "permits did not reduce the scheduling steps.");
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,250 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/sync/barrier.h"
+#include "coyote/sync/condition_variable.h"
+#include "coyote/sync/latch.h"
+#include "coyote/sync/mutex.h"
+#include "coyote/sync/semaphore.h"
+#include "coyote/sync/shared_mutex.h"
+
+using namespace coyote;
+
+constexpr auto THREAD_COUNT = 3;
+
+Scheduler* scheduler;
+
+int shared_var;
+int max_value_observed;
+int readers;
+int produced_items;
+int consumed_items;
+int completed_phases;
+
+void yield()
+{
+	if (scheduler->is_enabled())
+	{
+		scheduler->schedule_next();
+	}
+}
+
+void run_threads(void (*work)(int))
+{
+	if (scheduler->is_enabled())
+	{
+		scheduler->attach();
+	}
+
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		int thread_id = i + 1;
+		if (scheduler->is_enabled())
+		{
+			scheduler->create_operation(thread_id);
+		}
+
+		threads.push_back(std::make_unique<std::thread>([work, thread_id]()
+		{
+			if (scheduler->is_enabled())
+			{
+				scheduler->start_operation(thread_id);
+			}
+
+			work(thread_id);
+			if (scheduler->is_enabled())
+			{
+				scheduler->complete_operation(thread_id);
+			}
+		}));
+	}
+
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		if (scheduler->is_enabled())
+		{
+			scheduler->join_operation(i + 1);
+		}
+
+		threads[i]->join();
+	}
+
+	if (scheduler->is_enabled())
+	{
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+}
+
+std::unique_ptr<coyote::mutex> test_mutex;
+std::unique_ptr<coyote::shared_mutex> test_shared_mutex;
+std::unique_ptr<coyote::condition_variable> test_cv;
+std::unique_ptr<coyote::counting_semaphore<>> test_semaphore;
+std::unique_ptr<coyote::latch> test_latch;
+std::unique_ptr<coyote::barrier<std::function<void()>>> test_barrier;
+
+void mutex_work(int id)
+{
+	std::lock_guard<coyote::mutex> lock(*test_mutex);
+	shared_var = id;
+	yield();
+	assert(shared_var == id, "shared variable was modified while the mutex is held.");
+}
+
+void shared_mutex_work(int id)
+{
+	if (id == 1)
+	{
+		std::unique_lock<coyote::shared_mutex> lock(*test_shared_mutex);
+		assert(readers == 0, "a reader holds the shared mutex while the writer holds it.");
+		shared_var = id;
+		yield();
+		assert(shared_var == id, "shared variable was modified while the writer holds the shared mutex.");
+	}
+	else
+	{
+		std::shared_lock<coyote::shared_mutex> lock(*test_shared_mutex);
+		readers++;
+		yield();
+		readers--;
+	}
+}
+
+void condition_variable_work(int id)
+{
+	std::unique_lock<coyote::mutex> lock(*test_mutex);
+	if (id == 1)
+	{
+		for (int i = 0; i < THREAD_COUNT - 1; i++)
+		{
+			test_cv->wait(lock, []() { return produced_items > consumed_items; });
+			consumed_items++;
+		}
+	}
+	else
+	{
+		produced_items++;
+		test_cv->notify_one();
+		lock.unlock();
+		yield();
+		lock.lock();
+		test_cv->notify_all();
+	}
+}
+
+void semaphore_work(int id)
+{
+	test_semaphore->acquire();
+	shared_var++;
+	if (shared_var > max_value_observed)
+	{
+		max_value_observed = shared_var;
+	}
+
+	yield();
+	shared_var--;
+	test_semaphore->release();
+}
+
+void latch_work(int id)
+{
+	shared_var++;
+	test_latch->arrive_and_wait();
+	assert(shared_var == THREAD_COUNT, "the latch opened before all operations arrived.");
+}
+
+void barrier_work(int id)
+{
+	for (int phase = 0; phase < 2; phase++)
+	{
+		shared_var++;
+		test_barrier->arrive_and_wait();
+		assert(completed_phases == 2 * phase + 1, "the barrier phase did not complete.");
+		assert(shared_var == (phase + 1) * THREAD_COUNT, "the barrier released an operation early.");
+		test_barrier->arrive_and_wait();
+	}
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+	max_value_observed = 0;
+	readers = 0;
+	produced_items = 0;
+	consumed_items = 0;
+	completed_phases = 0;
+
+	test_mutex = std::make_unique<coyote::mutex>(scheduler);
+	test_shared_mutex = std::make_unique<coyote::shared_mutex>(scheduler);
+	test_cv = std::make_unique<coyote::condition_variable>(scheduler);
+	test_semaphore = std::make_unique<coyote::counting_semaphore<>>(scheduler, 2);
+	test_latch = std::make_unique<coyote::latch>(scheduler, THREAD_COUNT);
+	test_barrier = std::make_unique<coyote::barrier<std::function<void()>>>(scheduler, THREAD_COUNT,
+		[]() { completed_phases++; });
+
+	run_threads(mutex_work);
+	run_threads(shared_mutex_work);
+	run_threads(condition_variable_work);
+	assert(consumed_items == THREAD_COUNT - 1, "the consumer did not receive all items.");
+	shared_var = 0;
+	run_threads(semaphore_work);
+	assert(max_value_observed <= 2, "the semaphore admitted more operations than it has permits.");
+	shared_var = 0;
+	run_threads(latch_work);
+	shared_var = 0;
+	run_threads(barrier_work);
+	assert(completed_phases == 4, "the barrier did not complete all phases.");
+
+	test_mutex.reset();
+	test_shared_mutex.reset();
+	test_cv.reset();
+	test_semaphore.reset();
+	test_latch.reset();
+	test_barrier.reset();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_iteration();
+		}
+
+		delete scheduler;
+
+		// Without scheduling, the primitives use the native synchronization primitives.
+		auto settings = std::make_unique<Settings>();
+		settings->disable_scheduling();
+		scheduler = new Scheduler(std::move(settings));
+		for (int i = 0; i < 10; i++)
+		{
+			run_iteration();
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
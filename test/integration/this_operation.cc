@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/this_operation.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+// Runs the body of an operation that only refers to itself through 'this_operation'.
+void work(size_t expected_id)
+{
+	assert(this_operation::id() == expected_id, "the id of the current operation is unexpected.");
+	assert(this_operation::scheduler() == scheduler, "the scheduler of the current operation is unexpected.");
+
+	int value = shared_var;
+	this_operation::yield();
+	shared_var = value + 1;
+
+	assert(this_operation::complete(), ErrorCode::Success);
+	assert(this_operation::id() == this_operation::invalid_id, "the completed operation is still current.");
+}
+
+// Runs two operations, and returns true if an update was lost.
+bool run_iteration()
+{
+	shared_var = 0;
+	scheduler->attach();
+	assert(this_operation::id() == 0, "the main operation is not current after attaching.");
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1([]()
+	{
+		scheduler->start_operation(WORK_THREAD_1_ID);
+		work(WORK_THREAD_1_ID);
+	});
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2([]()
+	{
+		scheduler->start_operation(WORK_THREAD_2_ID);
+		work(WORK_THREAD_2_ID);
+	});
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(this_operation::id() == this_operation::invalid_id, "an operation is current after detaching.");
+	return shared_var != 2;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		int lost_updates = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			lost_updates += run_iteration() ? 1 : 0;
+		}
+
+		assert(lost_updates > 0, "the lost update was not found.");
+
+		// A thread that did not start an operation has no current operation.
+		std::thread t([]()
+		{
+			assert(this_operation::id() == this_operation::invalid_id, "an unstarted thread has an operation.");
+			assert(this_operation::yield(), ErrorCode::OperationNotStarted);
+		});
+
+		t.join();
+		delete scheduler;
+
+		// The operation of a deleted scheduler is not current, even if its client did not detach.
+		for (bool detach : { true, false })
+		{
+			scheduler = new Scheduler();
+			assert(scheduler->attach(), ErrorCode::Success);
+			if (detach)
+			{
+				assert(scheduler->detach(), ErrorCode::Success);
+			}
+
+			delete scheduler;
+			assert(this_operation::id() == this_operation::invalid_id, "an operation of a deleted scheduler is current.");
+			assert(this_operation::scheduler() == nullptr, "a deleted scheduler is current.");
+			assert(this_operation::yield(), ErrorCode::OperationNotStarted);
+			assert(this_operation::complete(), ErrorCode::OperationNotStarted);
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
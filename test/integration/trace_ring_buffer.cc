@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/trace/trace_ring_buffer.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + 1;
+	scheduler->complete_operation(id);
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+// Consumes the available events directly from the shared memory of the buffer, as a host would, and
+// returns the number of consumed events.
+size_t consume(TraceRingBufferHeader* header, uint64_t iteration)
+{
+	const TraceEvent* events = reinterpret_cast<const TraceEvent*>(reinterpret_cast<const char*>(header) +
+		header->events_offset);
+	uint64_t read_cursor = header->read_cursor.load(std::memory_order_relaxed);
+	uint64_t write_cursor = header->write_cursor.load(std::memory_order_acquire);
+	for (uint64_t i = read_cursor; i < write_cursor; i++)
+	{
+		const TraceEvent& event = events[i % header->capacity];
+		assert(event.sequence == i - read_cursor, "the events are out of order.");
+		if (i == read_cursor)
+		{
+			assert(event.type == TraceEventType::IterationStarted && event.operation_id == iteration,
+				"the iteration did not start with an event.");
+		}
+		else if (i == write_cursor - 1)
+		{
+			assert(event.type == TraceEventType::IterationCompleted && event.operation_id == iteration,
+				"the iteration did not complete with an event.");
+		}
+	}
+
+	header->read_cursor.store(write_cursor, std::memory_order_release);
+	return (size_t)(write_cursor - read_cursor);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+
+		auto ring_buffer = std::make_unique<TraceRingBuffer>(1024);
+		TraceRingBufferHeader* header = ring_buffer->header();
+		scheduler->set_trace_sink(std::move(ring_buffer));
+
+		// A host reads the statistics concurrently with the scheduler, and each copy must be consistent.
+		const StatisticsSnapshot* snapshot = scheduler->statistics_snapshot();
+		std::atomic<bool> is_reading(true);
+		std::atomic<bool> is_consistent(true);
+		std::thread reader([&]()
+		{
+			ExplorationStatistics iteration_statistics, total_statistics;
+			while (is_reading.load())
+			{
+				snapshot->read(iteration_statistics, total_statistics);
+				if (iteration_statistics.steps > total_statistics.steps ||
+					total_statistics.context_switches > total_statistics.steps)
+				{
+					is_consistent.store(false);
+				}
+			}
+		});
+
+		ExplorationStatistics iteration_statistics, total_statistics;
+		for (uint64_t i = 1; i <= 100; i++)
+		{
+			run_iteration();
+			assert(consume(header, i) > 0, "no events were written.");
+			snapshot->read(iteration_statistics, total_statistics);
+			assert(iteration_statistics.steps == scheduler->iteration_statistics().steps,
+				"the shared iteration statistics are stale.");
+			assert(total_statistics.iterations == i, "the shared total statistics are stale.");
+			assert(snapshot->sequence.load() % 2 == 0, "the statistics snapshot was left inconsistent.");
+		}
+
+		is_reading.store(false);
+		reader.join();
+		assert(is_consistent.load(), "an inconsistent copy of the statistics was read.");
+
+		assert(header->dropped_count.load() == 0, "events were dropped although the buffer was consumed.");
+
+		// If the host falls behind, the events that do not fit are dropped instead of overwriting the
+		// unread ones.
+		auto small_buffer = std::make_unique<TraceRingBuffer>(4);
+		TraceRingBuffer* small_buffer_ptr = small_buffer.get();
+		header = small_buffer->header();
+		scheduler->set_trace_sink(std::move(small_buffer));
+		run_iteration();
+
+		assert(header->write_cursor.load() == 4, "the full buffer was not filled.");
+		assert(header->dropped_count.load() > 0, "no events were dropped from the full buffer.");
+
+		TraceEvent event;
+		for (uint64_t i = 0; i < 4; i++)
+		{
+			assert(small_buffer_ptr->try_read(event) && event.sequence == i, "the unread events were overwritten.");
+		}
+
+		assert(!small_buffer_ptr->try_read(event), "an event was read from the empty buffer.");
+
+		// A host can register its own memory, which stays valid after the ring buffer is replaced, so
+		// the events of the last iteration can still be consumed.
+		std::vector<TraceEvent> memory(TraceRingBuffer::required_size(1024) / sizeof(TraceEvent) + 1);
+		scheduler->set_trace_sink(std::make_unique<TraceRingBuffer>(memory.data(), memory.size() * sizeof(TraceEvent)));
+		header = reinterpret_cast<TraceRingBufferHeader*>(memory.data());
+		assert(header->capacity >= 1024, "the host memory does not hold the requested capacity.");
+		assert(header->events_offset >= sizeof(TraceRingBufferHeader) &&
+			header->events_offset + header->capacity * sizeof(TraceEvent) <= memory.size() * sizeof(TraceEvent),
+			"the events are not stored in the host memory after the header.");
+		run_iteration();
+
+		scheduler->set_trace_sink(nullptr);
+		assert(consume(header, 102) > 0, "no events were written to the host memory.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
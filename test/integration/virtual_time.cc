@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/sync/condition_variable.h"
+#include "coyote/sync/mutex.h"
+#include "coyote/sync/sleep.h"
+
+using namespace coyote;
+using namespace std::chrono_literals;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+
+Scheduler* scheduler;
+
+int first_woken_id;
+bool is_signaled;
+
+void run_operations(void (*work_1)(), void (*work_2)())
+{
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1([work_1]()
+	{
+		scheduler->start_operation(WORK_THREAD_1_ID);
+		work_1();
+		scheduler->complete_operation(WORK_THREAD_1_ID);
+	});
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2([work_2]()
+	{
+		scheduler->start_operation(WORK_THREAD_2_ID);
+		work_2();
+		scheduler->complete_operation(WORK_THREAD_2_ID);
+	});
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+}
+
+void test_sleep()
+{
+	first_woken_id = 0;
+	scheduler->attach();
+
+	// The operation with the shorter sleep always wakes up first, regardless of the schedule.
+	run_operations([]()
+	{
+		sleep_for(scheduler, 10s);
+		if (first_woken_id == 0)
+		{
+			first_woken_id = WORK_THREAD_1_ID;
+		}
+	}, []()
+	{
+		sleep_for(scheduler, 5s);
+		if (first_woken_id == 0)
+		{
+			first_woken_id = WORK_THREAD_2_ID;
+		}
+	});
+
+	assert(first_woken_id == WORK_THREAD_2_ID, "the operation with the longer sleep woke up first.");
+	assert(scheduler->virtual_time() == 10s, "the virtual time did not advance to the last timer.");
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test_timed_wait(std::chrono::nanoseconds signal_delay, bool expected_is_signaled,
+	std::chrono::nanoseconds expected_time)
+{
+	static std::chrono::nanoseconds delay;
+	delay = signal_delay;
+	is_signaled = !expected_is_signaled;
+
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+	run_operations([]()
+	{
+		scheduler->wait_resource_for(RESOURCE_ID, 1s, is_signaled);
+	}, []()
+	{
+		scheduler->sleep_for(delay);
+		scheduler->signal_resource(RESOURCE_ID);
+	});
+
+	assert(is_signaled == expected_is_signaled, "the timed wait returned an unexpected result.");
+	assert(scheduler->virtual_time() == expected_time, "the virtual time is unexpected.");
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test_condition_variable_timeout()
+{
+	scheduler->attach();
+	{
+		coyote::mutex mutex(scheduler);
+		coyote::condition_variable cv(scheduler);
+		std::unique_lock<coyote::mutex> lock(mutex);
+
+		// Nothing notifies the condition variable, so the wait times out instead of deadlocking.
+		assert(!cv.wait_for(lock, 100ms, []() { return false; }), "the predicate is unexpectedly satisfied.");
+		assert(scheduler->virtual_time() == 100ms, "the wait did not time out after 100ms.");
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			test_sleep();
+			test_timed_wait(500ms, true, 500ms);
+			test_timed_wait(2s, false, 2s);
+			test_condition_variable_timeout();
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	// Each iteration sleeps for seconds of virtual time, which must not be spent in real time.
+	size_t elapsed = total_time(start_time);
+	if (elapsed > 10000)
+	{
+		std::cout << "[test] failed: the virtual time was spent in real time." << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << elapsed << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+std::mutex mutex;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+
+	// The main thread joins a thread that waits for a mutex that the main thread holds.
+	std::lock_guard<std::mutex> lock(mutex);
+	std::thread thread([]()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+	});
+
+	thread.join();
+	std::cout << "[test] failed: the deadlock was not detected." << std::endl;
+	return 1;
+}
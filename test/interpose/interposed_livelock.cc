@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <iostream>
+#include <sched.h>
+#include <thread>
+
+std::atomic<bool> is_ready(false);
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+
+	// The thread yields while it waits for a flag that is never set.
+	std::thread thread([]()
+	{
+		while (!is_ready.load())
+		{
+			sched_yield();
+		}
+	});
+
+	thread.join();
+	std::cout << "[test] failed: the livelock was not detected." << std::endl;
+	return 1;
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr auto THREAD_COUNT = 4;
+constexpr auto ITEM_COUNT = 10;
+constexpr auto SHORT_LIVED_MUTEX_COUNT = 200;
+
+std::mutex mutex;
+std::condition_variable cv;
+int shared_var = 0;
+int produced_items = 0;
+int consumed_items = 0;
+
+sem_t semaphore;
+int semaphore_holders = 0;
+int max_semaphore_holders = 0;
+
+void* semaphore_work(void*)
+{
+	sem_wait(&semaphore);
+	semaphore_holders++;
+	if (semaphore_holders > max_semaphore_holders)
+	{
+		max_semaphore_holders = semaphore_holders;
+	}
+
+	sched_yield();
+	semaphore_holders--;
+	sem_post(&semaphore);
+	return nullptr;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		threads.emplace_back([]()
+		{
+			for (int j = 0; j < ITEM_COUNT; j++)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				int value = shared_var;
+				sched_yield();
+				shared_var = value + 1;
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (shared_var != THREAD_COUNT * ITEM_COUNT)
+	{
+		std::cout << "[test] failed: the mutex did not provide mutual exclusion." << std::endl;
+		return 1;
+	}
+
+	std::thread consumer([]()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (consumed_items < ITEM_COUNT)
+		{
+			cv.wait(lock, []() { return produced_items > consumed_items; });
+			consumed_items++;
+		}
+	});
+
+	std::thread producer([]()
+	{
+		for (int i = 0; i < ITEM_COUNT; i++)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			produced_items++;
+			cv.notify_one();
+		}
+	});
+
+	producer.join();
+	consumer.join();
+
+	sem_init(&semaphore, 0, 2);
+	pthread_t semaphore_threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		pthread_create(&semaphore_threads[i], nullptr, semaphore_work, nullptr);
+	}
+
+	for (int i = 0; i < THREAD_COUNT; i++)
+	{
+		pthread_join(semaphore_threads[i], nullptr);
+	}
+
+	sem_destroy(&semaphore);
+	if (max_semaphore_holders > 2)
+	{
+		std::cout << "[test] failed: the semaphore admitted more threads than it has permits." << std::endl;
+		return 1;
+	}
+
+	// Contended mutexes that are created and destroyed over and over leave removed entries behind in the
+	// tracked objects, which must not break finding the live ones.
+	int short_lived_var = 0;
+	for (int i = 0; i < SHORT_LIVED_MUTEX_COUNT; i++)
+	{
+		pthread_mutex_t short_lived_mutex;
+		pthread_mutex_init(&short_lived_mutex, nullptr);
+		auto work = [&]()
+		{
+			pthread_mutex_lock(&short_lived_mutex);
+			int value = short_lived_var;
+			sched_yield();
+			short_lived_var = value + 1;
+			pthread_mutex_unlock(&short_lived_mutex);
+		};
+
+		std::thread first(work);
+		std::thread second(work);
+		first.join();
+		second.join();
+		pthread_mutex_destroy(&short_lived_mutex);
+	}
+
+	if (short_lived_var != 2 * SHORT_LIVED_MUTEX_COUNT)
+	{
+		std::cout << "[test] failed: a short-lived mutex did not provide mutual exclusion." << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done." << std::endl;
+	return 0;
+}
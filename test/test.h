@@ -20,6 +20,8 @@ std::string error_message(ErrorCode error_code)
 				return "failure";
 		case ErrorCode::DeadlockDetected:
 				return "deadlock detected";
+		case ErrorCode::PotentialLivelockDetected:
+				return "potential livelock detected";
 		case ErrorCode::DuplicateOperation:
 				return "operation already exists";
 		case ErrorCode::NotExistingOperation:
@@ -40,6 +42,8 @@ std::string error_message(ErrorCode error_code)
 				return "resource already exists";
 		case ErrorCode::NotExistingResource:
 				return "resource does not exist";
+		case ErrorCode::ResourceNotHeld:
+				return "lock is not held by the operation";
 		case ErrorCode::ClientAttached:
 				return "client is already attached to the scheduler";
 		case ErrorCode::ClientNotAttached:
@@ -48,6 +52,8 @@ std::string error_message(ErrorCode error_code)
 				return "internal error";
 		case ErrorCode::SchedulerDisabled:
 				return "scheduler is disabled";
+		case ErrorCode::CommandNotExecuted:
+				return "command was not executed";
 		default:
 				return "(unknown error)";
 		}
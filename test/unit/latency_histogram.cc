@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/statistics/latency_histogram.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		auto histogram = std::make_unique<LatencyHistogram>();
+		assert(histogram->count() == 0, "unexpected count of empty histogram");
+		assert(histogram->percentile(50) == 0, "unexpected percentile of empty histogram");
+
+		// Small values are recorded exactly.
+		for (uint64_t value = 1; value <= 10; value++)
+		{
+			histogram->record(value);
+		}
+
+		assert(histogram->count() == 10, "unexpected count");
+		assert(histogram->min() == 1, "unexpected min");
+		assert(histogram->max() == 10, "unexpected max");
+		assert(histogram->mean() == 5.5, "unexpected mean");
+		assert(histogram->percentile(50) == 5, "unexpected median");
+		assert(histogram->percentile(100) == 10, "unexpected max percentile");
+
+		// Large values are recorded with a bounded relative error.
+		histogram->clear();
+		assert(histogram->count() == 0, "unexpected count after clear");
+		for (uint64_t value = 1000; value <= 1000000; value += 1000)
+		{
+			histogram->record(value);
+		}
+
+		uint64_t median = histogram->percentile(50);
+		assert(median >= 500000 && median <= 500000 + 500000 / 16, "unexpected large median");
+		uint64_t tail = histogram->percentile(99);
+		assert(tail >= 990000 && tail <= 1000000, "unexpected large tail");
+		assert(histogram->percentile(100) == 1000000, "unexpected large max percentile");
+
+		histogram->clear();
+		histogram->record(UINT64_MAX);
+		assert(histogram->percentile(50) == UINT64_MAX, "unexpected max value percentile");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -138,6 +138,98 @@ int main()
 		assert(int_choices[i] == value, "unexpected int choice");
 	}
 
+	// Drive a strategy through the operation events, as the scheduler does.
+	auto event_strategy = std::make_unique<PCTStrategy>(settings.get());
+	for (int i = 0; i < num_ops; i++)
+	{
+		event_strategy->on_operation_created(i, Operation::ungrouped_id);
+		event_strategy->on_operation_enabled(i);
+	}
+
+	op = event_strategy->next_operation(ops, 0);
+	assert(op == 0, "unexpected op before blocking");
+
+	ops.disable(op);
+	event_strategy->on_operation_blocked(op);
+	size_t next_op = event_strategy->next_operation(ops, op);
+	assert(next_op != op, "unexpected blocked op");
+
+	ops.enable(op);
+	event_strategy->on_operation_enabled(op);
+	next_op = event_strategy->next_operation(ops, next_op);
+	assert(next_op == op, "unexpected op after enabling");
+
+	// In adaptive mode, the bound ramps up through the configured range, giving each bound twice the
+	// iterations of the previous one, and once the schedule length is known every priority change point
+	// falls inside the schedule.
+	const std::array<size_t, 8> adaptive_bounds = { 1, 2, 2, 3, 3, 3, 3, 3 };
+	auto adaptive_settings = std::make_unique<Settings>();
+	adaptive_settings->use_adaptive_pct_strategy(seed, 1, 3);
+	auto adaptive_strategy = std::make_unique<PCTStrategy>(adaptive_settings.get());
+	for (size_t iteration = 1; iteration <= adaptive_bounds.size(); iteration++)
+	{
+		if (iteration > 1)
+		{
+			adaptive_strategy->prepare_next_iteration(iteration);
+		}
+
+		size_t bound = adaptive_strategy->exploration_strategy_bound();
+		assert(bound == adaptive_bounds[iteration - 1], "unexpected adaptive bound");
+
+		num_priority_changes = 0;
+		op = 0;
+		for (int i = 0; i < num_ops; i++)
+		{
+			next_op = adaptive_strategy->next_operation(ops, op);
+			if (op != next_op)
+			{
+				num_priority_changes++;
+			}
+
+			op = next_op;
+		}
+
+		if (iteration > 1)
+		{
+			assert(num_priority_changes == bound, "unexpected number of adaptive priority changes");
+		}
+	}
+
+	// In adaptive mode, the priority change points fall more often on the choice steps that have more
+	// enabled operations, here the second half of each schedule.
+	auto weighted_settings = std::make_unique<Settings>();
+	weighted_settings->use_adaptive_pct_strategy(seed, 1, 1);
+	auto weighted_strategy = std::make_unique<PCTStrategy>(weighted_settings.get());
+	const size_t half_length = num_ops / 2;
+	size_t first_half_changes = 0;
+	size_t second_half_changes = 0;
+	for (size_t iteration = 1; iteration <= 200; iteration++)
+	{
+		if (iteration > 1)
+		{
+			weighted_strategy->prepare_next_iteration(iteration);
+		}
+
+		Operations few_ops;
+		few_ops.insert(0);
+		few_ops.insert(1);
+
+		op = 0;
+		for (size_t step = 0; step < 2 * half_length; step++)
+		{
+			next_op = weighted_strategy->next_operation(step < half_length ? few_ops : ops, op);
+			if (op != next_op && step > 0 && step != half_length)
+			{
+				// The enabled operations did not change, so the switch is a priority change point.
+				(step < half_length ? first_half_changes : second_half_changes)++;
+			}
+
+			op = next_op;
+		}
+	}
+
+	assert(second_half_changes > 3 * first_half_changes, "the priority change points were not weighted");
+
 	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
 	return 0;
 }
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <array>
+#include <set>
+#include "test.h"
+#include "coyote/strategies/pctcp_strategy.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+	std::cout << "[test] seed: " << seed << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+
+	const size_t num_priority_change_points = 3;
+
+	auto settings = std::make_unique<Settings>();
+	settings->use_pctcp_strategy(seed, num_priority_change_points);
+
+	auto strategy = std::make_unique<PCTCPStrategy>(settings.get());
+	auto replay_strategy = std::make_unique<PCTCPStrategy>(settings.get());
+
+	const int num_ops = 20;
+	const int num_groups = 4;
+
+	std::array<size_t, num_ops> initial_op_choices;
+	std::array<size_t, num_ops> op_choices;
+
+	Operations ops;
+	for (int i = 0; i < num_ops; i++)
+	{
+		ops.insert(i);
+	}
+
+	auto create_operations = [&](PCTCPStrategy* pctcp)
+	{
+		pctcp->on_operation_created(0, Operation::ungrouped_id);
+		for (int i = 1; i < num_ops; i++)
+		{
+			pctcp->on_operation_created(i, i % num_groups);
+		}
+	};
+
+	create_operations(strategy.get());
+	assert(strategy->chains_count() == num_groups + 1, "unexpected number of chains");
+
+	size_t op = 0;
+	for (int i = 0; i < num_ops; i++)
+	{
+		size_t next_op = strategy->next_operation(ops, op);
+
+		// We are expecting that during the first iteration PCTCP will not context switch.
+		assert(op == next_op, "unexpected op during first iteration");
+		initial_op_choices[i] = op = next_op;
+	}
+
+	strategy->prepare_next_iteration(2);
+	create_operations(strategy.get());
+
+	std::set<size_t> scheduled_ops;
+	size_t num_priority_changes = 0;
+	op = 0;
+	for (int i = 0; i < num_ops; i++)
+	{
+		size_t next_op = strategy->next_operation(ops, op);
+		if (i > 0 && op != next_op)
+		{
+			num_priority_changes++;
+		}
+
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] PCTCP op choice: " << next_op << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+		scheduled_ops.insert(next_op);
+		op_choices[i] = op = next_op;
+	}
+
+	assert(num_priority_changes == num_priority_change_points, "unexpected number of priority changes");
+
+	// Only the first created operation of each chain can be scheduled, as none of them completes.
+	for (size_t scheduled_op : scheduled_ops)
+	{
+		assert(scheduled_op <= num_groups, "unexpected op from the middle of a chain");
+	}
+
+	// Completing the head of a chain must hand the chain to its next operation.
+	strategy->on_operation_completed(op);
+	ops.remove(op);
+	size_t next_op = strategy->next_operation(ops, op);
+	assert(next_op == op + num_groups || (op == 0 && next_op != 0), "unexpected op after completing chain head");
+	ops.insert(op);
+
+	create_operations(replay_strategy.get());
+	op = 0;
+	for (int i = 0; i < num_ops; i++)
+	{
+		op = replay_strategy->next_operation(ops, op);
+		assert(initial_op_choices[i] == op, "unexpected op");
+	}
+
+	replay_strategy->prepare_next_iteration(2);
+	create_operations(replay_strategy.get());
+
+	op = 0;
+	for (int i = 0; i < num_ops; i++)
+	{
+		op = replay_strategy->next_operation(ops, op);
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] replaying op choice: " << op << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+		assert(op_choices[i] == op, "unexpected op");
+	}
+
+	// The enabled operations can also be maintained through the operation events, as the scheduler does.
+	auto event_strategy = std::make_unique<PCTCPStrategy>(settings.get());
+	create_operations(event_strategy.get());
+	for (int i = 0; i < num_ops; i++)
+	{
+		event_strategy->on_operation_enabled(i);
+	}
+
+	op = event_strategy->next_operation(ops, 0);
+	assert(op == 0, "unexpected op with the initial priority");
+
+	// Blocking the head of the chain with the highest priority hands the execution to its next enabled
+	// operation, and enabling the head again hands it back.
+	event_strategy->on_operation_blocked(0);
+	ops.remove(0);
+	size_t head_op = event_strategy->next_operation(ops, 0);
+	assert(head_op > 0 && head_op <= num_groups, "unexpected op after blocking the first chain");
+
+	event_strategy->on_operation_blocked(head_op);
+	ops.remove(head_op);
+	next_op = event_strategy->next_operation(ops, head_op);
+	assert(next_op == head_op + num_groups, "unexpected op after blocking the chain head");
+
+	event_strategy->on_operation_enabled(head_op);
+	ops.insert(head_op);
+	next_op = event_strategy->next_operation(ops, next_op);
+	assert(next_op == head_op, "unexpected op after enabling the chain head");
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <array>
+#include "test.h"
+#include "coyote/strategies/portfolio_strategy.h"
+
+using namespace coyote;
+
+constexpr int NUM_OPS = 20;
+
+// The values that reproduce an iteration explored by the portfolio.
+struct ExploredIteration
+{
+	size_t index;
+	StrategyType type;
+	size_t bound;
+	uint64_t seed;
+	size_t strategy_iteration;
+	std::array<size_t, NUM_OPS> op_choices;
+};
+
+// Installs a standalone strategy with the reported type, bound and seed, runs it until the reported
+// iteration, and checks that it chooses the same operations in that iteration.
+void replay_standalone(const ExploredIteration& explored, Operations& ops, bool is_buggy)
+{
+	auto settings = std::make_unique<Settings>();
+	std::unique_ptr<Strategy> strategy;
+	if (explored.type == StrategyType::PCT)
+	{
+		settings->use_pct_strategy(explored.seed, explored.bound);
+		strategy = std::make_unique<PCTStrategy>(settings.get());
+	}
+	else
+	{
+		assert(explored.type == StrategyType::Random, "unexpected strategy type");
+		settings->use_random_strategy(explored.seed, explored.bound);
+		strategy = std::make_unique<RandomStrategy>(settings.get());
+	}
+
+	for (size_t iteration = 1; iteration <= explored.strategy_iteration; iteration++)
+	{
+		if (iteration > 1)
+		{
+			strategy->prepare_next_iteration(iteration);
+		}
+
+		size_t op = 0;
+		for (int i = 0; i < NUM_OPS; i++)
+		{
+			op = strategy->next_operation(ops, op);
+			if (iteration == explored.strategy_iteration)
+			{
+				assert(explored.op_choices[i] == op, "the standalone strategy chose an unexpected op");
+			}
+		}
+
+		if (is_buggy)
+		{
+			strategy->on_bug_found();
+		}
+	}
+
+	assert(strategy->exploration_strategy_iteration() == explored.strategy_iteration,
+		"unexpected standalone strategy iteration");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+	std::cout << "[test] seed: " << seed << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+
+	auto settings = std::make_unique<Settings>();
+	settings->use_portfolio_strategy(seed);
+	settings->add_portfolio_strategy(StrategyType::Random, 100);
+	settings->add_portfolio_strategy(StrategyType::Random, 10);
+	settings->add_portfolio_strategy(StrategyType::PCT, 3);
+
+	auto strategy = std::make_unique<PortfolioStrategy>(settings.get());
+	auto replay_strategy = std::make_unique<PortfolioStrategy>(settings.get());
+
+	const int num_iterations = 200;
+	const size_t buggy_strategy = 2;
+
+	std::array<size_t, num_iterations> strategy_choices;
+	std::array<std::array<size_t, NUM_OPS>, num_iterations> op_choices;
+	std::array<size_t, 3> strategy_counts = { 0, 0, 0 };
+	std::array<ExploredIteration, 3> last_iterations;
+
+	Operations ops;
+	for (int i = 0; i < NUM_OPS; i++)
+	{
+		ops.insert(i);
+	}
+
+	for (int iteration = 0; iteration < num_iterations; iteration++)
+	{
+		if (iteration > 0)
+		{
+			strategy->prepare_next_iteration(iteration + 1);
+		}
+
+		size_t index = strategy->iteration_strategy_index();
+		if (iteration < 3)
+		{
+			// Each strategy in the portfolio must explore one iteration before the bandit kicks in.
+			assert(index == (size_t)iteration, "unexpected initial strategy");
+		}
+
+		strategy_choices[iteration] = index;
+		strategy_counts[index]++;
+
+		size_t op = 0;
+		for (int i = 0; i < NUM_OPS; i++)
+		{
+			op = strategy->next_operation(ops, op);
+			op_choices[iteration][i] = op;
+		}
+
+		last_iterations[index] = ExploredIteration{ index, strategy->exploration_strategy(),
+			strategy->exploration_strategy_bound(), strategy->exploration_strategy_seed(),
+			strategy->exploration_strategy_iteration(), op_choices[iteration] };
+		assert(strategy->exploration_strategy_iteration() == strategy_counts[index],
+			"unexpected strategy iteration");
+
+		if (index == buggy_strategy)
+		{
+			assert(strategy->exploration_strategy() == StrategyType::PCT, "unexpected strategy type");
+			assert(strategy->exploration_strategy_bound() == 3, "unexpected strategy bound");
+			strategy->on_bug_found();
+		}
+	}
+
+	assert(strategy_counts[buggy_strategy] > strategy_counts[0] &&
+		strategy_counts[buggy_strategy] > strategy_counts[1], "expected the bug finding strategy to be preferred");
+
+	// The last iteration of each strategy, and in particular the last buggy one, can be reproduced
+	// without the portfolio from the reported values.
+	for (const ExploredIteration& explored : last_iterations)
+	{
+		replay_standalone(explored, ops, explored.index == buggy_strategy);
+	}
+
+	for (int iteration = 0; iteration < num_iterations; iteration++)
+	{
+		if (iteration > 0)
+		{
+			replay_strategy->prepare_next_iteration(iteration + 1);
+		}
+
+		size_t index = replay_strategy->iteration_strategy_index();
+		assert(strategy_choices[iteration] == index, "unexpected strategy");
+
+		size_t op = 0;
+		for (int i = 0; i < NUM_OPS; i++)
+		{
+			op = replay_strategy->next_operation(ops, op);
+			assert(op_choices[iteration][i] == op, "unexpected op");
+		}
+
+		if (index == buggy_strategy)
+		{
+			replay_strategy->on_bug_found();
+		}
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
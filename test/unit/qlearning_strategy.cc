@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <array>
+#include "test.h"
+#include "coyote/strategies/qlearning_strategy.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+	std::cout << "[test] seed: " << seed << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+
+	auto settings = std::make_unique<Settings>();
+	settings->use_qlearning_strategy(seed);
+
+	auto strategy = std::make_unique<QLearningStrategy>(settings.get());
+	auto replay_strategy = std::make_unique<QLearningStrategy>(settings.get());
+
+	const int num_iterations = 10;
+	const int num_ops = 20;
+
+	std::array<std::array<size_t, num_ops>, num_iterations> op_choices;
+
+	Operations ops;
+	for (int i = 0; i < num_ops; i++)
+	{
+		ops.insert(i);
+	}
+
+	for (int iteration = 0; iteration < num_iterations; iteration++)
+	{
+		if (iteration > 0)
+		{
+			strategy->prepare_next_iteration(iteration + 1);
+			assert(strategy->learned_values_count() > 0, "unexpected empty Q-table");
+		}
+
+		size_t op = 0;
+		for (int i = 0; i < num_ops; i++)
+		{
+			op = strategy->next_operation(ops, op);
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] qlearning op choice: " << op << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+			assert(op < num_ops, "unexpected op");
+			op_choices[iteration][i] = op;
+		}
+	}
+
+	// The learned Q-values only depend on the seed and the explored schedules, so replaying the
+	// same sequence of iterations must produce the same choices.
+	for (int iteration = 0; iteration < num_iterations; iteration++)
+	{
+		if (iteration > 0)
+		{
+			replay_strategy->prepare_next_iteration(iteration + 1);
+		}
+
+		size_t op = 0;
+		for (int i = 0; i < num_ops; i++)
+		{
+			op = replay_strategy->next_operation(ops, op);
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] replaying op choice: " << op << std::endl;
+#endif // !COYOTE_DEBUG_LOG
+			assert(op_choices[iteration][i] == op, "unexpected op");
+		}
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
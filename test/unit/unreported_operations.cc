@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/strategies/pct_strategy.h"
+#include "coyote/strategies/pctcp_strategy.h"
+
+using namespace coyote;
+
+// Checks that the strategy only chooses enabled operations when the scheduler does not report the
+// operation events, even if an operation is enabled in place of another one, so that the number of
+// enabled operations does not change.
+template<typename TStrategy>
+void check_swapped_operations(Settings* settings)
+{
+	auto strategy = std::make_unique<TStrategy>(settings);
+
+	Operations ops;
+	ops.insert(0);
+	ops.insert(1);
+	ops.insert(2);
+
+	size_t op = strategy->next_operation(ops, 0);
+	assert(op <= 2, "an unknown operation was chosen.");
+
+	// Replace the chosen operation with a new one, and then enable it again in place of the next chosen
+	// operation, so that the number of enabled operations stays the same.
+	ops.disable(op);
+	ops.insert(3);
+	size_t next_op = strategy->next_operation(ops, op);
+	assert(next_op != op, "a disabled operation was chosen.");
+
+	ops.enable(op);
+	ops.disable(next_op);
+	assert(strategy->next_operation(ops, next_op) != next_op, "a disabled operation was chosen.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		for (uint64_t seed = 0; seed < 100; seed++)
+		{
+			auto settings = std::make_unique<Settings>();
+			settings->use_pct_strategy(seed, 3);
+			check_swapped_operations<PCTStrategy>(settings.get());
+
+			settings->use_adaptive_pct_strategy(seed, 1, 3);
+			check_swapped_operations<PCTStrategy>(settings.get());
+
+			settings->use_pctcp_strategy(seed, 3);
+			check_swapped_operations<PCTCPStrategy>(settings.get());
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}